@@ -31,18 +31,24 @@ struct DiffCase
 
 struct BenchResult
 {
-    Clock::duration old_diff = {};
-    Clock::duration old_dist = {};
-    Clock::duration new_diff = {};
-    Clock::duration new_dist = {};
+    Clock::duration old_diff    = {};
+    Clock::duration old_dist    = {};
+    Clock::duration new_diff    = {};
+    Clock::duration new_dist    = {};
+    Clock::duration scalar_diff = {};
+    Clock::duration scalar_dist = {};
+    Clock::duration hist_diff   = {};
 
     BenchResult operator/(std::size_t divisor) const
     {
         return {
-            .old_diff = old_diff / divisor,
-            .old_dist = old_dist / divisor,
-            .new_diff = new_diff / divisor,
-            .new_dist = new_dist / divisor,
+            .old_diff    = old_diff / divisor,
+            .old_dist    = old_dist / divisor,
+            .new_diff    = new_diff / divisor,
+            .new_dist    = new_dist / divisor,
+            .scalar_diff = scalar_diff / divisor,
+            .scalar_dist = scalar_dist / divisor,
+            .hist_diff   = hist_diff / divisor,
         };
     }
 
@@ -52,6 +58,9 @@ struct BenchResult
         old_dist += other.old_dist;
         new_diff += other.new_diff;
         new_dist += other.new_dist;
+        scalar_diff += other.scalar_diff;
+        scalar_dist += other.scalar_dist;
+        hist_diff += other.hist_diff;
 
         return *this;
     }
@@ -101,7 +110,7 @@ constexpr auto hello2
 
 void print(const BenchResult& result)
 {
-    const auto& [old_diff, old_dist, new_diff, new_dist] = result;
+    const auto& [old_diff, old_dist, new_diff, new_dist, scalar_diff, scalar_dist, hist_diff] = result;
 
     using Ms   = std::chrono::duration<float, std::milli>;
     auto to_ms = [](Clock::duration dur) { return std::chrono::duration_cast<Ms>(dur); };
@@ -119,14 +128,38 @@ void print(const BenchResult& result)
         );
     };
 
+    // for algorithms that have no separate edit distance computation
+    auto print_diff_result = [](std::string_view name, float diff, long diff_d) {
+        fmt::println(
+            "| {:>10} | {:>7.2f} ({:>4}%) | {:>15} |",
+            name,
+            diff,
+            fmt::styled(diff_d, fmt::bg(diff_d > 0 ? fmt::color::orange_red : fmt::color::green)),
+            "-"
+        );
+    };
+
     auto diff_delta = 100 * (new_diff - old_diff) / old_diff;
     auto dist_delta = 100 * (new_dist - old_dist) / old_dist;
 
+    auto scalar_diff_delta = 100 * (scalar_diff - old_diff) / old_diff;
+    auto scalar_dist_delta = 100 * (scalar_dist - old_dist) / old_dist;
+
+    auto hist_diff_delta = 100 * (hist_diff - old_diff) / old_diff;
+
     print_border();
     print_header();
     print_border();
     print_result("dtl", to_ms(old_diff).count(), to_ms(old_dist).count(), 0, 0);
     print_result("dtlx", to_ms(new_diff).count(), to_ms(new_dist).count(), diff_delta, dist_delta);
+    print_result(
+        "dtlx (sc)",
+        to_ms(scalar_diff).count(),
+        to_ms(scalar_dist).count(),
+        scalar_diff_delta,
+        scalar_dist_delta
+    );
+    print_diff_result("dtlx (hs)", to_ms(hist_diff).count(), hist_diff_delta);
     print_border();
 }
 
@@ -172,6 +205,14 @@ std::string generate_string(std::mt19937& rng, std::size_t max_len)
     return string;
 }
 
+// long strings that only differ in a handful of places, the diff is dominated by long snakes
+DiffCase generate_near_identical_case(std::mt19937& rng, std::size_t len, std::size_t mutation_count)
+{
+    auto left  = generate_string(rng, len);
+    auto right = mutate_string(rng, left, mutation_count);
+    return { std::move(left), std::move(right) };
+}
+
 std::vector<DiffCase> generate_diff_cases(std::mt19937& rng, std::size_t count)
 {
     constexpr std::size_t max_len = 20000;
@@ -223,6 +264,27 @@ long run_new(const DiffCase& diff, bool dist_only)
     }
 }
 
+// same as run_new but a custom comparison function disables the vectorized snake
+long run_scalar(const DiffCase& diff, bool dist_only)
+{
+    auto&& [left, right] = diff;
+    auto comp            = [](char l, char r) { return l == r; };
+    if (dist_only) {
+        return dtlx::edit_distance(left, right, comp);
+    } else {
+        auto [lcs, ses, dist] = dtlx::diff(left, right, comp);
+        return dist;
+    }
+}
+
+// histogram diff, the edit distance is that of its (not always minimal) SES
+long run_histogram(const DiffCase& diff, bool /* dist_only */)
+{
+    auto&& [left, right] = diff;
+    auto [lcs, ses, dist] = dtlx::diff(left, right, {}, { .algorithm = dtlx::DiffAlgorithm::Histogram });
+    return dist;
+}
+
 BenchResult bench(std::span<const DiffCase> cases, std::size_t run_count)
 {
     auto total = BenchResult{};
@@ -239,19 +301,23 @@ BenchResult bench(std::span<const DiffCase> cases, std::size_t run_count)
     for (auto i = 0u; i < cases.size(); ++i) {
         const auto& diff = cases[i];
 
-        auto dist_old = run_old(diff, true);
-        auto dist_new = run_new(diff, true);
+        auto dist_old  = run_old(diff, true);
+        auto dist_new  = run_new(diff, true);
+        auto dist_hist = run_histogram(diff, false);
 
         auto result = BenchResult{
             run(run_old, diff, false),
             run(run_old, diff, true),
             run(run_new, diff, false),
             run(run_new, diff, true),
+            run(run_scalar, diff, false),
+            run(run_scalar, diff, true),
+            run(run_histogram, diff, false),
         };
 
         total += result;
 
-        fmt::println("\ncase: {} (edit: {} vs {})", i, dist_old, dist_new);
+        fmt::println("\ncase: {} (edit: {} vs {}, histogram: {})", i, dist_old, dist_new, dist_hist);
         print(result);
     }
 
@@ -315,6 +381,7 @@ int main(int argc, char* argv[])
 
     auto cases = generate_diff_cases(rng, *num_cases);
     cases.emplace_back(std::string{ hello1 }, std::string{ hello2 });
+    cases.push_back(generate_near_identical_case(rng, 1'000'000, 20));
 
     fmt::println("\ncases:");
     for (auto i = 0u; i < cases.size(); ++i) {
@@ -71,7 +71,9 @@ int main(int argc, char* argv[])
     auto file1_lines = generate_line_by_line(file1_content);
     auto file2_lines = generate_line_by_line(file2_content);
 
-    auto diff = dtlx::diff(file1_lines.list, file2_lines.list);
+    // compare lines by their ids instead of comparing the strings themselves
+    auto table = dtlx::InternTable<std::string_view>{};
+    auto diff  = dtlx::diff(file1_lines.list, file2_lines.list, table);
 
     for (auto&& [elem, info] : diff.ses.get()) {
         const auto red   = fmt::bg(fmt::color::red);
@@ -4,13 +4,17 @@
 #include "dtlx/concepts.hpp"
 
 #include <cassert>
+#include <concepts>
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace dtlx
 {
     using i64 = std::int64_t;
     using u64 = std::uint64_t;
+    using i32 = std::int32_t;
+    using u32 = std::uint32_t;
 
     /**
      * @enum SesEdit
@@ -40,6 +44,22 @@ namespace dtlx
         }
     }
 
+    /**
+     * @enum DiffAlgorithm
+     *
+     * @brief Algorithm used to compute the diff.
+     *
+     * (*) Requires the elements to be hashable with `std::hash` and compared with `std::equal_to`, use an
+     *     `InternTable` for other elements; falls back to `Onp` otherwise.
+     */
+    enum class DiffAlgorithm
+    {
+        Onp,          // Wu's O(NP) algorithm, segmented by `DiffFlags::limit` (same as dtl)
+        Linear,       // Myers' divide-and-conquer in linear space, always minimal
+        Patience,     // anchored on elements that occur once on each side, O(NP) in between (*)
+        Histogram,    // split on the least frequent common elements, O(NP) if they are too frequent (*)
+    };
+
     /**
      * @struct ElemInfo
      *
@@ -55,65 +75,92 @@ namespace dtlx
         bool operator==(const ElemInfo&) const  = default;
     };
 
+    namespace detail
+    {
+        /**
+         * @struct KPoint
+         *
+         * @brief Edit graph/grid coordinate.
+         *
+         * @tparam I Index type, `i32` is used when the edit graph is small enough to halve the memory usage.
+         */
+        template <std::signed_integral I = i64>
+        struct KPoint
+        {
+            I x;
+            I y;
+            I k;    // diagonal
+
+            auto operator<=>(const KPoint&) const = default;
+            bool operator==(const KPoint&) const  = default;
+        };
+
+        /**
+         * @struct Point
+         *
+         * @brief Edit graph/grid coordinate without diagonal.
+         *
+         * @tparam I Index type.
+         */
+        template <std::signed_integral I = i64>
+        struct Point
+        {
+            I x;
+            I y;
+
+            auto operator<=>(const Point&) const = default;
+            bool operator==(const Point&) const  = default;
+        };
+
+        /**
+         * @struct EditPath
+         *
+         * @brief Edit path for a sequence.
+         *
+         * @tparam I Index type.
+         */
+        template <std::signed_integral I = i64>
+        struct EditPath
+        {
+            EditPath() = default;
+
+            EditPath(u64 size, I value)
+                : inner(size, value)
+            {
+            }
+
+            // clang-format off
+            I&       operator[](u64 index)       { return inner[index]; }
+            const I& operator[](u64 index) const { return inner[index]; }
+
+            I&       at(i64 index)       { assert(index >= 0); return inner[static_cast<u64>(index)]; }
+            const I& at(i64 index) const { assert(index >= 0); return inner[static_cast<u64>(index)]; }
+
+            void        add(I value)          { inner.push_back(value); }
+            std::size_t size() const noexcept { return inner.size(); }
+            void        clear() noexcept      { inner.clear(); }
+            // clang-format on
+
+            std::vector<I> inner;
+
+            bool operator==(const EditPath&) const = default;
+        };
+    }
+
     /**
-     * @struct KPoint
-     *
      * @brief Edit graph/grid coordinate.
      */
-    struct KPoint
-    {
-        i64 x;
-        i64 y;
-        i64 k;    // diagonal
-
-        auto operator<=>(const KPoint&) const = default;
-        bool operator==(const KPoint&) const  = default;
-    };
+    using KPoint = detail::KPoint<i64>;
 
     /**
-     * @struct Point
-     *
      * @brief Edit graph/grid coordinate without diagonal.
      */
-    struct Point
-    {
-        i64 x;
-        i64 y;
-
-        auto operator<=>(const Point&) const = default;
-        bool operator==(const Point&) const  = default;
-    };
+    using Point = detail::Point<i64>;
 
     /**
-     * @struct EditPath
-     *
      * @brief Edit path for a sequence.
      */
-    struct EditPath
-    {
-        EditPath() = default;
-
-        EditPath(u64 size, i64 value)
-            : inner(size, value)
-        {
-        }
-
-        // clang-format off
-        i64&       operator[](u64 index)       { return inner[index]; }
-        const i64& operator[](u64 index) const { return inner[index]; }
-
-        i64&       at(i64 index)       { assert(index >= 0); return inner[static_cast<u64>(index)]; }
-        const i64& at(i64 index) const { assert(index >= 0); return inner[static_cast<u64>(index)]; }
-
-        void        add(i64 value)        { inner.push_back(value); }
-        std::size_t size() const noexcept { return inner.size(); }
-        void        clear() noexcept      { inner.clear(); }
-        // clang-format on
-
-        std::vector<i64> inner;
-
-        bool operator==(const EditPath&) const = default;
-    };
+    using EditPath = detail::EditPath<i64>;
 
     /**
      * @struct EditPathCoords
@@ -180,10 +227,10 @@ namespace dtlx
         i64 c;
         i64 d;
 
-        std::vector<SesElem<Elem>> common_0;    // anteroposterior commons on changes
-        std::vector<SesElem<Elem>> common_1;
+        std::pmr::vector<SesElem<Elem>> common_0;    // anteroposterior commons on changes
+        std::pmr::vector<SesElem<Elem>> common_1;
 
-        std::vector<SesElem<Elem>> change;    // changes
+        std::pmr::vector<SesElem<Elem>> change;    // changes
 
         i64 inc_dec_count;    // count of increase and decrease
 
@@ -204,7 +251,7 @@ namespace dtlx
 
         std::span<const UniHunk<E>> get() const { return inner; }
 
-        std::vector<UniHunk<E>> inner;
+        std::pmr::vector<UniHunk<E>> inner;
 
         bool operator==(const UniHunkSeq&) const
             requires TriviallyComparable<E>
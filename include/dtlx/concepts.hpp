@@ -3,6 +3,7 @@
 
 #include <concepts>
 #include <ranges>
+#include <utility>
 
 namespace dtlx
 {
@@ -90,6 +91,30 @@ namespace dtlx
         requires Diffable<RangeElem<R1>>;
         requires Comparable<RangeElem<R1>, Comp>;
     };
+
+    /**
+     * @brief Template alias helper for getting the types of the ranges of a range of pairs (`std::get<0>` and
+     * `std::get<1>`, e.g. `std::pair` or `std::tuple`).
+     */
+    template <std::ranges::range Pairs>
+    using PairFirst = decltype(std::get<0>(std::declval<std::ranges::range_reference_t<Pairs>>()));
+
+    template <std::ranges::range Pairs>
+    using PairSecond = decltype(std::get<1>(std::declval<std::ranges::range_reference_t<Pairs>>()));
+
+    /**
+     * @brief Random access range of pairs of ranges that are `ComparableRanges`.
+     *
+     * @tparam Pairs The range of pairs type.
+     * @tparam Comp The comparison function type.
+     */
+    template <typename Pairs, typename Comp>
+    concept ComparableRangePairs = requires {
+        requires RandomAccessRange<Pairs>;
+        requires SizedRange<Pairs>;
+
+        requires ComparableRanges<PairFirst<Pairs>, PairSecond<Pairs>, Comp>;
+    };
 }
 
 #endif /* end of include guard: DTLX_CONCEPTS_HPP */
@@ -23,6 +23,19 @@ namespace dtlx::constants
     // limit of coordinate size, default value is the same as one used in dtl
     constexpr std::size_t default_limit = 2'000'000;
     constexpr std::size_t no_limit      = std::numeric_limits<std::size_t>::max();
+
+    // minimum size (sum of both sides) of a sub-problem for it to be scheduled as its own task
+    constexpr std::size_t parallel_min_size = 16'384;
+
+    // minimum number of edits of a SES in each chunk of a parallel patch
+    constexpr std::size_t patch_min_chunk_size = 65'536;
+
+    // elements that occur more often than this are not used as split points by the histogram algorithm,
+    // same value as the one used by git
+    constexpr std::size_t histogram_max_occurrences = 64;
+
+    // maximum size of the shorter side for `edit_distance` to use bit-vectors instead of O(NP)
+    constexpr std::size_t bit_parallel_max_size = 256;
 }
 
 #endif /* end of include guard: DTLX_CONSTANTS_HPP */
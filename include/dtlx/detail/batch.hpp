@@ -0,0 +1,59 @@
+#ifndef DTLX_DETAIL_BATCH_HPP
+#define DTLX_DETAIL_BATCH_HPP
+
+#include "dtlx/common.hpp"
+#include "dtlx/detail/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace dtlx::detail
+{
+    /**
+     * @brief Run `fn(index)` for every item of a batch on `threads` threads (including the caller).
+     *
+     * The items are taken in decreasing order of `sizes` from a shared counter, so that the largest ones start
+     * first and the small ones fill the gaps at the end instead of a large one starting last on its own.
+     */
+    template <typename Fn>
+    void run_batch(std::span<const u64> sizes, u64 threads, Fn fn)
+    {
+        auto order = std::vector<std::size_t>(sizes.size());
+        std::iota(order.begin(), order.end(), std::size_t{ 0 });
+        std::ranges::stable_sort(order, std::greater{}, [&](std::size_t i) { return sizes[i]; });
+
+        auto next = std::atomic<std::size_t>{ 0 };
+        auto work = [&] {
+            for (auto i = next.fetch_add(1); i < order.size(); i = next.fetch_add(1)) {
+                fn(order[i]);
+            }
+        };
+
+        threads = std::min(threads, static_cast<u64>(order.size()));
+        if (threads <= 1) {
+            work();
+            return;
+        }
+
+        auto pool    = ThreadPool{ threads - 1 };
+        auto futures = std::vector<std::future<void>>{};
+
+        futures.reserve(threads - 1);
+        for (u64 i = 0; i < threads - 1; ++i) {
+            futures.push_back(pool.submit(work));
+        }
+
+        work();
+        for (auto& future : futures) {
+            pool.wait(future);
+        }
+    }
+}
+
+#endif /* end of include guard: DTLX_DETAIL_BATCH_HPP */
@@ -0,0 +1,318 @@
+#ifndef DTLX_DETAIL_BIT_PARALLEL_HPP
+#define DTLX_DETAIL_BIT_PARALLEL_HPP
+
+#include "dtlx/common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <ranges>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace dtlx::detail
+{
+    /**
+     * @brief Elements whose edit distance can be computed with bit-vectors.
+     *
+     * The pattern-match vectors are looked up by element value, so the comparison must be the default one.
+     */
+    template <typename E, typename Comp>
+    concept BitParallel = requires {
+        requires std::integral<E>;
+        requires std::same_as<Comp, std::equal_to<>> or std::same_as<Comp, std::equal_to<E>>;
+    };
+
+    inline constexpr std::size_t word_bits = 64;
+
+    /**
+     * @class PatternMatch
+     *
+     * @brief Positions of each element value in the pattern as bit-vectors, one bit per pattern element.
+     *
+     * The vector of a value is split into blocks of 64 bits. Elements of one byte are looked up directly (on
+     * the stack if the pattern fits in a single block), wider ones through a hash map.
+     */
+    template <std::integral E>
+    class PatternMatch
+    {
+    public:
+        template <std::ranges::random_access_range R>
+        explicit PatternMatch(const R& pattern)
+            : m_size{ std::ranges::size(pattern) }
+            , m_blocks{ (m_size + word_bits - 1) / word_bits }
+        {
+            if constexpr (s_direct) {
+                if (m_blocks > 1) {
+                    m_rows.resize(s_byte_values * m_blocks, 0);
+                }
+            } else {
+                m_rows.resize(m_blocks, 0);    // row 0 is shared by the values that are not in the pattern
+            }
+
+            auto it = std::ranges::begin(pattern);
+            for (std::size_t i = 0; i < m_size; ++i, ++it) {
+                row_for_insert(*it)[i / word_bits] |= u64{ 1 } << (i % word_bits);
+            }
+        }
+
+        std::size_t size() const noexcept { return m_size; }
+        std::size_t blocks() const noexcept { return m_blocks; }
+
+        // mask of the valid bits of the last block
+        u64 last_mask() const noexcept
+        {
+            return m_size % word_bits == 0 ? ~u64{ 0 } : (u64{ 1 } << (m_size % word_bits)) - 1;
+        }
+
+        const u64* row(E elem) const
+        {
+            if constexpr (s_direct) {
+                auto value = static_cast<std::size_t>(static_cast<Byte>(elem));
+                return m_blocks > 1 ? m_rows.data() + value * m_blocks : &m_small[value];
+            } else {
+                auto it = m_index.find(elem);
+                return m_rows.data() + (it == m_index.end() ? 0 : it->second) * m_blocks;
+            }
+        }
+
+    private:
+        static constexpr bool        s_direct      = sizeof(E) == 1;
+        static constexpr std::size_t s_byte_values = 256;
+
+        // `std::make_unsigned` is not defined for `bool`
+        using Byte = typename std::
+            conditional_t<std::same_as<E, bool>, std::type_identity<unsigned char>, std::make_unsigned<E>>::type;
+
+        u64* row_for_insert(E elem)
+        {
+            if constexpr (s_direct) {
+                return const_cast<u64*>(row(elem));
+            } else {
+                auto [it, inserted] = m_index.try_emplace(elem, m_rows.size() / m_blocks);
+                if (inserted) {
+                    m_rows.resize(m_rows.size() + m_blocks, 0);
+                }
+                return m_rows.data() + it->second * m_blocks;
+            }
+        }
+
+        struct Empty
+        {
+        };
+
+        using Small = std::conditional_t<s_direct, std::array<u64, s_byte_values>, Empty>;
+        using Index = std::conditional_t<s_direct, Empty, std::unordered_map<E, std::size_t>>;
+
+        std::size_t      m_size;
+        std::size_t      m_blocks;
+        std::vector<u64> m_rows;
+
+        [[no_unique_address]] Small m_small = {};
+        [[no_unique_address]] Index m_index = {};
+    };
+
+    /**
+     * @brief Length of the LCS of the pattern and the text.
+     *
+     * Each pattern element has a bit in V that is cleared once it is matched, the bits are updated for a
+     * whole block of the pattern at once: V' = (V + U) | (V - U) where U = V & match.
+     *
+     * READ: https://doi.org/10.1007/978-3-540-27801-6_12 (Hyyrö, Bit-parallel LCS-length computation revisited)
+     */
+    template <std::integral E, std::ranges::input_range R>
+    i64 bit_parallel_lcs(const PatternMatch<E>& peq, const R& text)
+    {
+        if (peq.size() == 0) {
+            return 0;
+        }
+
+        auto unmatched = i64{ 0 };
+
+        if (peq.blocks() == 1) {
+            auto v = ~u64{ 0 };
+            for (const auto& elem : text) {
+                auto u = v & *peq.row(elem);
+                v      = (v + u) | (v - u);
+            }
+            unmatched = std::popcount(v & peq.last_mask());
+        } else {
+            auto v = std::vector<u64>(peq.blocks(), ~u64{ 0 });
+            for (const auto& elem : text) {
+                const auto* match = peq.row(elem);
+                auto        carry = u64{ 0 };
+
+                for (std::size_t b = 0; b < v.size(); ++b) {
+                    auto u   = v[b] & match[b];
+                    auto sum = v[b] + u;
+                    auto out = static_cast<u64>(sum < u);
+
+                    sum   += carry;
+                    out   |= static_cast<u64>(sum < carry);
+                    v[b]   = sum | (v[b] - u);
+                    carry  = out;
+                }
+            }
+
+            for (std::size_t b = 0; b + 1 < v.size(); ++b) {
+                unmatched += std::popcount(v[b]);
+            }
+            unmatched += std::popcount(v.back() & peq.last_mask());
+        }
+
+        return static_cast<i64>(peq.size()) - unmatched;
+    }
+
+    /**
+     * @brief Advance one block of the vertical delta vectors by one text element.
+     *
+     * @param pv Positive vertical deltas of the block.
+     * @param mv Negative vertical deltas of the block.
+     * @param eq Pattern-match vector of the text element for the block.
+     * @param hin Horizontal delta coming from the block above (-1, 0, or 1).
+     * @param high Mask of the bit of the last row of the block.
+     *
+     * @return Horizontal delta at the last row of the block.
+     */
+    inline i64 advance_block(u64& pv, u64& mv, u64 eq, i64 hin, u64 high) noexcept
+    {
+        auto hin_neg = static_cast<u64>(hin < 0);
+        auto hin_pos = static_cast<u64>(hin > 0);
+
+        auto xv = eq | mv;
+        eq |= hin_neg;
+        auto xh = (((eq & pv) + pv) ^ pv) | eq;
+
+        auto ph = mv | ~(xh | pv);
+        auto mh = pv & xh;
+
+        auto hout = i64{ (ph & high) != 0 } - i64{ (mh & high) != 0 };
+
+        ph = (ph << 1) | hin_pos;
+        mh = (mh << 1) | hin_neg;
+
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        return hout;
+    }
+
+    /**
+     * @brief Levenshtein distance (insertion, deletion, and substitution cost 1) of the pattern and the text.
+     *
+     * READ: https://doi.org/10.1145/316542.316550 (Myers, A fast bit-vector algorithm for approximate string
+     *       matching based on dynamic programming)
+     * READ: https://doi.org/10.1007/3-540-44888-8_6 (Hyyrö, A bit-vector algorithm for computing Levenshtein and
+     *       Damerau edit distances), for the blocks
+     */
+    template <std::integral E, std::ranges::input_range R>
+    i64 bit_parallel_levenshtein(const PatternMatch<E>& peq, const R& text)
+    {
+        auto score = static_cast<i64>(peq.size());
+        if (score == 0) {
+            return static_cast<i64>(std::ranges::distance(text));
+        }
+
+        const auto high_last = u64{ 1 } << ((peq.size() - 1) % word_bits);
+        const auto high      = u64{ 1 } << (word_bits - 1);
+
+        auto pv = std::vector<u64>(peq.blocks(), ~u64{ 0 });
+        auto mv = std::vector<u64>(peq.blocks(), 0);
+
+        const auto last = peq.blocks() - 1;
+
+        for (const auto& elem : text) {
+            const auto* match = peq.row(elem);
+
+            auto h = i64{ 1 };    // the first row grows by one for each text element
+            for (std::size_t b = 0; b < last; ++b) {
+                h = advance_block(pv[b], mv[b], match[b], h, high);
+            }
+            score += advance_block(pv[last], mv[last], match[last], h, high_last);
+        }
+
+        return score;
+    }
+
+    /**
+     * @brief Strip the common prefix and suffix of two ranges, they do not change the edit distance.
+     *
+     * @return The remaining middle parts of the ranges.
+     */
+    template <typename R1, typename R2>
+    auto strip_common(const R1& lhs, const R2& rhs)
+    {
+        auto [l_begin, r_begin] = std::ranges::mismatch(lhs, rhs);
+
+        auto l_end = std::ranges::next(std::ranges::begin(lhs), std::ranges::end(lhs));
+        auto r_end = std::ranges::next(std::ranges::begin(rhs), std::ranges::end(rhs));
+        while (l_end != l_begin and r_end != r_begin and *std::ranges::prev(l_end) == *std::ranges::prev(r_end)) {
+            --l_end;
+            --r_end;
+        }
+
+        return std::pair{ std::ranges::subrange{ l_begin, l_end }, std::ranges::subrange{ r_begin, r_end } };
+    }
+
+    /**
+     * @brief Indel distance (what `edit_distance` computes) using bit-vectors over the shorter range.
+     */
+    template <typename R1, typename R2>
+    i64 bit_parallel_indel_distance(const R1& lhs, const R2& rhs)
+    {
+        using E = std::ranges::range_value_t<R1>;
+
+        auto [a, b] = strip_common(lhs, rhs);
+        auto size   = static_cast<i64>(std::ranges::size(a) + std::ranges::size(b));
+
+        auto lcs = std::ranges::size(a) <= std::ranges::size(b) ? bit_parallel_lcs(PatternMatch<E>{ a }, b)
+                                                                 : bit_parallel_lcs(PatternMatch<E>{ b }, a);
+        return size - 2 * lcs;
+    }
+
+    /**
+     * @brief Levenshtein distance using bit-vectors over the shorter range.
+     */
+    template <typename R1, typename R2>
+    i64 bit_parallel_levenshtein_distance(const R1& lhs, const R2& rhs)
+    {
+        using E = std::ranges::range_value_t<R1>;
+
+        auto [a, b] = strip_common(lhs, rhs);
+
+        return std::ranges::size(a) <= std::ranges::size(b) ? bit_parallel_levenshtein(PatternMatch<E>{ a }, b)
+                                                             : bit_parallel_levenshtein(PatternMatch<E>{ b }, a);
+    }
+
+    /**
+     * @brief Levenshtein distance for any element type, one row of the dynamic programming table at a time.
+     */
+    template <typename R1, typename R2, typename Comp>
+    i64 levenshtein_distance(const R1& lhs, const R2& rhs, const Comp& comp)
+    {
+        auto row = std::vector<i64>(std::ranges::size(rhs) + 1);
+        for (std::size_t j = 0; j < row.size(); ++j) {
+            row[j] = static_cast<i64>(j);
+        }
+
+        for (const auto& l : lhs) {
+            auto diagonal = row[0]++;
+
+            auto j = std::size_t{ 1 };
+            for (const auto& r : rhs) {
+                auto substitute = diagonal + (comp(l, r) ? 0 : 1);
+                diagonal        = row[j];
+                row[j]          = std::min({ substitute, row[j] + 1, row[j - 1] + 1 });
+                ++j;
+            }
+        }
+
+        return row.back();
+    }
+}
+
+#endif /* end of include guard: DTLX_DETAIL_BIT_PARALLEL_HPP */
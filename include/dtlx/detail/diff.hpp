@@ -3,14 +3,27 @@
 
 #include "dtlx/common.hpp"
 #include "dtlx/constants.hpp"
+#include "dtlx/detail/snake.hpp"
+#include "dtlx/detail/thread_pool.hpp"
+#include "dtlx/index_ses.hpp"
 #include "dtlx/lcs.hpp"
+#include "dtlx/run_ses.hpp"
 #include "dtlx/ses.hpp"
+#include "dtlx/workspace.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <functional>
+#include <future>
+#include <limits>
+#include <optional>
 #include <ranges>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace dtlx::detail
 {
@@ -31,13 +44,173 @@ namespace dtlx::detail
         = default;
     };
 
+    /**
+     * @struct SesRecorder
+     *
+     * @brief Records the edits found by the diff algorithm into an LCS and a SES.
+     *
+     * The algorithms only go through `add`, `part`, `append`, and `lcs_size` of their recorder, so the result
+     * can be recorded in other forms (see `IndexRecorder`) without changing them.
+     */
+    template <Diffable E>
+    struct SesRecorder
+    {
+        Lcs<E> lcs;
+        Ses<E> ses;
+
+        void add(const E& elem, i64 index_before, i64 index_after, SesEdit type)
+        {
+            if (type == SesEdit::Common) {
+                lcs.add(elem);
+            }
+            ses.add(elem, index_before, index_after, type);
+        }
+
+        // an empty recorder for a part of the result that is computed separately, e.g. on another thread
+        SesRecorder part() const { return { Lcs<E>{}, Ses<E>{ ses.is_swapped() } }; }
+
+        void append(SesRecorder&& other)
+        {
+            lcs.append(std::move(other.lcs));
+            ses.append(std::move(other.ses));
+        }
+
+        i64 lcs_size() const { return static_cast<i64>(lcs.get().size()); }
+    };
+
+    /**
+     * @struct IndexDiffResult
+     *
+     * @brief The result of the diff algorithm without copies of the elements.
+     */
+    struct [[nodiscard]] IndexDiffResult
+    {
+        IndexSes ses;
+        i64      edit_distance = 0;
+
+        bool operator==(const IndexDiffResult&) const = default;
+    };
+
+    /**
+     * @struct IndexRecorder
+     *
+     * @brief Records only the indices of the edits, the LCS is only counted.
+     */
+    struct IndexRecorder
+    {
+        IndexSes ses;
+        i64      commons = 0;
+
+        template <typename E>
+        void add(const E&, i64 index_before, i64 index_after, SesEdit type)
+        {
+            commons += type == SesEdit::Common;
+            ses.add(index_before, index_after, type);
+        }
+
+        IndexRecorder part() const { return { IndexSes{ ses.is_swapped() } }; }
+
+        void append(IndexRecorder&& other)
+        {
+            ses.append(std::move(other.ses));
+            commons += other.commons;
+        }
+
+        i64 lcs_size() const { return commons; }
+    };
+
+    /**
+     * @struct RunDiffResult
+     *
+     * @brief The result of the diff algorithm as runs of edits.
+     */
+    template <Diffable E>
+    struct [[nodiscard]] RunDiffResult
+    {
+        RunSes<E> ses;
+        i64       edit_distance = 0;
+
+        bool operator==(const RunDiffResult&) const
+            requires TriviallyComparable<E>
+        = default;
+    };
+
+    /**
+     * @struct RunRecorder
+     *
+     * @brief Records the edits as runs, the common runs found by following a diagonal are added at once.
+     */
+    template <Diffable E>
+    struct RunRecorder
+    {
+        RunSes<E> ses;
+        i64       commons = 0;
+
+        void add(const E& elem, i64 index_before, i64 index_after, SesEdit type)
+        {
+            commons += type == SesEdit::Common;
+            ses.add(elem, index_before, index_after, type);
+        }
+
+        void add_common(i64 index_before, i64 index_after, i64 length)
+        {
+            commons += length;
+            ses.add_common(index_before, index_after, length);
+        }
+
+        RunRecorder part() const { return { RunSes<E>{ ses.is_swapped() } }; }
+
+        void append(RunRecorder&& other)
+        {
+            ses.append(std::move(other.ses));
+            commons += other.commons;
+        }
+
+        i64 lcs_size() const { return commons; }
+    };
+
+    /**
+     * @brief Recorders that can take a whole run of common elements at once.
+     */
+    template <typename Out>
+    concept RunRecordable = requires (Out& out, i64 index) { out.add_common(index, index, index); };
+
+    /**
+     * @brief Elements that can be grouped by their hash, required to find the elements that occur once.
+     *
+     * The comparison must be the default one so that equal elements are guaranteed to have equal hashes.
+     */
+    template <typename E, typename Comp>
+    concept HashGroupable = requires (const E e) {
+        { std::hash<E>{}(e) } -> std::convertible_to<std::size_t>;
+        requires std::same_as<Comp, std::equal_to<>> or std::same_as<Comp, std::equal_to<E>>;
+    };
+
+    /**
+     * @struct OnpLimits
+     *
+     * @brief Limits of a single run of the O(NP) algorithm.
+     *
+     * A run that hits one of the limits stops at the furthest point it reached, and the rest of the sequences
+     * is diffed again from there. The SES is still valid but may not be minimal.
+     */
+    struct OnpLimits
+    {
+        // maximum number of coordinates recorded, the run stops on the diagonal of the end point
+        u64 max_coords_size = constants::default_limit;
+
+        // maximum number of rounds (each round extends every diagonal by one edit), the run stops on the
+        // diagonal that got the furthest
+        u64 max_cost = constants::no_limit;
+    };
+
     // READ: https://publications.mpi-cbg.de/Wu_1990_6334.pdf
     template <Diffable E, Comparator<E> Comp, ComparableRange<Comp> R1, ComparableRange<Comp> R2, bool Swap>
     class Diff
     {
     public:
-        using Subrange1 = std::ranges::subrange<std::ranges::iterator_t<R1>, std::ranges::sentinel_t<R1>>;
-        using Subrange2 = std::ranges::subrange<std::ranges::iterator_t<R2>, std::ranges::sentinel_t<R2>>;
+        using Subrange1 = std::ranges::subrange<std::ranges::iterator_t<R1>>;
+        using Subrange2 = std::ranges::subrange<std::ranges::iterator_t<R2>>;
 
         struct RecordSequenceStatus
         {
@@ -68,68 +241,236 @@ namespace dtlx::detail
             std::variant<Complete, Incomplete> inner;
         };
 
-        Diff(R1 lhs, R2 rhs, Comp comp)
+        Diff(R1 lhs, R2 rhs, Comp comp, i64 ox = 0, i64 oy = 0)
             : m_comp{ comp }
         {
-            init_state(lhs, rhs, 0, 0);
+            auto lhs_begin = std::ranges::begin(lhs);
+            auto rhs_begin = std::ranges::begin(rhs);
+
+            auto A = Subrange1{ lhs_begin, lhs_begin + std::ranges::ssize(lhs) };
+            auto B = Subrange2{ rhs_begin, rhs_begin + std::ranges::ssize(rhs) };
+
+            init_state(A, B, ox, oy);
+        }
+
+        // run the O(NP) algorithm and append the result to out, returns the edit distance
+        template <typename Out>
+        i64 record_diff(
+            Out&           out,
+            OnpLimits      limits,
+            bool           reserve_first,
+            bool           trim_suffix,
+            DiffWorkspace& workspace
+        )
+        {
+            record_head(out, trim_suffix);
+
+            auto edit_distance = fits_i32(limits.max_coords_size)
+                                   ? record_segments(out, limits, reserve_first, workspace.lease<i32>())
+                                   : record_segments(out, limits, reserve_first, workspace.lease<i64>());
+
+            record_tail(out);
+
+            return edit_distance;
+        }
+
+        // the same as record_diff split into steps for a caller that may not need the whole SES: the common
+        // prefix first, then one segment of the O(NP) loop per call, then the common suffix
+        template <typename Out>
+        void record_head(Out& out, bool trim_suffix)
+        {
+            trim_state(trim_suffix);
+            record_common(out, m_head_A, m_head_B, m_head_ox, m_head_oy);
+        }
+
+        // returns the edit distance of the segment and whether it was the last one
+        template <typename Out>
+        std::pair<i64, bool> record_next_segment(
+            Out&           out,
+            OnpLimits      limits,
+            bool           reserve_first,
+            DiffWorkspace& workspace
+        )
+        {
+            auto run = [&](auto&& buffers) {
+                if (reserve_first and limits.max_coords_size != constants::no_limit) {
+                    buffers->path_coords.inner.reserve(limits.max_coords_size);
+                }
+                return record_segment(out, limits, *buffers);
+            };
+
+            return fits_i32(limits.max_coords_size) ? run(workspace.lease<i32>()) : run(workspace.lease<i64>());
+        }
+
+        template <typename Out>
+        void record_tail(Out& out) const
+        {
+            record_common(out, m_tail_A, m_tail_B, m_tail_ox, m_tail_oy);
         }
 
-        DiffResult<E> diff(u64 max_coords_size, bool reserve_first)
+        // READ: https://doi.org/10.1007/BF01840446 (section 4b, linear space refinement)
+        template <typename Out>
+        i64 diff_linear(Out& out, u64 threads, u64 min_task_size)
         {
-            auto furthest_points = std::vector<i64>(static_cast<u64>(m_M + m_N + 3), -1);
+            trim_state(true);
 
-            auto path                = EditPath{ static_cast<u64>(m_M + m_N + 3), -1 };
-            auto path_coords         = EditPathCoords{};
-            auto reduced_path_coords = EditPathCoords<Point>{};
+            record_common(out, m_head_A, m_head_B, m_head_ox, m_head_oy);
 
-            if (reserve_first and max_coords_size != constants::no_limit) {
-                path_coords.inner.reserve(max_coords_size);
+            if (threads > 1) {
+                auto pool = ThreadPool{ threads - 1 };
+                linear_solve(out, { 0, m_M, 0, m_N }, &pool, min_task_size);
+            } else {
+                linear_solve(out, { 0, m_M, 0, m_N }, nullptr, min_task_size);
             }
 
-            auto lcs           = Lcs<E>{};
-            auto ses           = Ses<E>{ Swap };
-            auto edit_distance = i64{ 0 };
+            record_common(out, m_tail_A, m_tail_B, m_tail_ox, m_tail_oy);
 
-            while (true) {
-                edit_distance += record_edits(furthest_points, path, path_coords, max_coords_size);
+            return edit_distance_from(out);
+        }
 
-                auto r = path.at(m_delta + m_offset);
-                while (r != -1) {
-                    auto [x, y, k] = path_coords.at(r);
-                    reduced_path_coords.add(Point{ x, y });
-                    r = k;
+        // run the O(NP) algorithm on independent segments, concurrently with more than one thread; the segments
+        // are separated by elements that occur once on both sides (the same anchors as the patience algorithm) and
+        // are at least `min_segment_size` long. the calling thread solves the first segment and any segment it
+        // picks up while waiting with `workspace`, the pool workers use their own default workspace
+        template <typename Out>
+        i64 diff_anchored(
+            Out&           out,
+            OnpLimits      limits,
+            u64            threads,
+            u64            min_segment_size,
+            DiffWorkspace& workspace
+        )
+            requires HashGroupable<E, Comp>
+        {
+            record_anchored_head(out, min_segment_size);
+
+            if (threads > 1 and m_segments.size() > 1) {
+                auto pool    = ThreadPool{ threads - 1 };
+                auto futures = std::vector<std::future<Out>>{};
+                auto caller  = std::this_thread::get_id();
+
+                auto workspace_here = [&]() -> DiffWorkspace& {
+                    return std::this_thread::get_id() == caller ? workspace : default_workspace();
+                };
+
+                futures.reserve(m_segments.size() - 1);
+                for (auto segment : m_segments | std::views::drop(1)) {
+                    futures.push_back(pool.submit([=, this, part = out.part()]() mutable {
+                        onp_solve(part, segment, limits, workspace_here());
+                        return std::move(part);
+                    }));
                 }
 
-                auto status = record_sequence(lcs, ses, reduced_path_coords);
-                if (status.is_complete()) {
-                    break;
+                onp_solve(out, m_segments[0], limits, workspace);
+
+                for (std::size_t i = 1; i < m_segments.size(); ++i) {
+                    record_diagonal(out, m_segments[i - 1].x1, m_segments[i - 1].y1, 1);    // the anchor
+                    out.append(pool.wait(futures[i - 1]));
                 }
+            } else {
+                auto last = false;
+                while (not last) {
+                    last = record_next_anchored_segment(out, limits, workspace);
+                }
+            }
 
-                auto [new_A, new_B, new_ox, new_oy] = std::move(status).as_incomplete();
-                init_state(new_A, new_B, new_ox, new_oy);
+            record_tail(out);
 
-                furthest_points.clear();
-                furthest_points.resize(static_cast<u64>(m_M + m_N + 3), -1);
-                std::ranges::fill(path.inner, -1);
+            return edit_distance_from(out);
+        }
 
-                path_coords.clear();
-                reduced_path_coords.clear();
+        // the same as diff_anchored on one thread split into steps: the common prefix (the common suffix is
+        // stripped too), then one segment and the anchor after it per call, then the common suffix with
+        // record_tail
+        template <typename Out>
+        void record_anchored_head(Out& out, u64 min_segment_size)
+            requires HashGroupable<E, Comp>
+        {
+            trim_state(true);
+            record_common(out, m_head_A, m_head_B, m_head_ox, m_head_oy);
+
+            m_segments     = anchored_segments({ 0, m_M, 0, m_N }, min_segment_size);
+            m_next_segment = 0;
+        }
+
+        // returns whether the segment was the last one
+        template <typename Out>
+        bool record_next_anchored_segment(Out& out, OnpLimits limits, DiffWorkspace& workspace)
+        {
+            auto segment = m_segments[m_next_segment];
+            onp_solve(out, segment, limits, workspace);
+
+            if (++m_next_segment == m_segments.size()) {
+                return true;
             }
 
-            return {
-                .lcs           = std::move(lcs),
-                .ses           = std::move(ses),
-                .edit_distance = edit_distance,
-            };
+            record_diagonal(out, segment.x1, segment.y1, 1);    // the anchor
+            return false;
         }
 
-        i64 edit_distance() const
+        // READ: https://bramcohen.livejournal.com/73318.html
+        template <typename Out>
+        i64 diff_patience(Out& out, OnpLimits limits, DiffWorkspace& workspace)
+            requires HashGroupable<E, Comp>
         {
-            auto furthest_points = std::vector<i64>(static_cast<u64>(m_M + m_N + 3), -1);
-            return calculate_edit_distance(furthest_points);
+            trim_state(true);
+
+            record_common(out, m_head_A, m_head_B, m_head_ox, m_head_oy);
+            patience_solve(out, { 0, m_M, 0, m_N }, limits, workspace);
+            record_common(out, m_tail_A, m_tail_B, m_tail_ox, m_tail_oy);
+
+            return edit_distance_from(out);
+        }
+
+        // READ: https://github.com/eclipse-jgit/jgit/blob/master/org.eclipse.jgit/src/org/eclipse/jgit/diff/HistogramDiff.java
+        template <typename Out>
+        i64 diff_histogram(Out& out, OnpLimits limits, DiffWorkspace& workspace)
+            requires HashGroupable<E, Comp>
+        {
+            trim_state(true);
+
+            record_common(out, m_head_A, m_head_B, m_head_ox, m_head_oy);
+            histogram_solve(out, { 0, m_M, 0, m_N }, limits, workspace);
+            record_common(out, m_tail_A, m_tail_B, m_tail_ox, m_tail_oy);
+
+            return edit_distance_from(out);
+        }
+
+        i64 edit_distance(DiffWorkspace& workspace)
+        {
+            trim_state(true);
+
+            auto buffers = workspace.lease<i64>();
+            buffers->furthest_points.assign(static_cast<u64>(m_M + m_N + 3), -1);
+
+            return *calculate_edit_distance(buffers->furthest_points, std::numeric_limits<i64>::max());
+        }
+
+        // returns nullopt as soon as the edit distance is known to be greater than max_distance
+        std::optional<i64> edit_distance_within(i64 max_distance, DiffWorkspace& workspace)
+        {
+            trim_state(true);
+
+            if (m_delta > max_distance) {
+                return std::nullopt;
+            }
+
+            auto buffers = workspace.lease<i64>();
+            buffers->furthest_points.assign(static_cast<u64>(m_M + m_N + 3), -1);
+
+            return calculate_edit_distance(buffers->furthest_points, (max_distance - m_delta) / 2);
         }
 
     private:
+        // half-open region of the edit graph: [x0, x1) of A and [y0, y1) of B
+        struct Box
+        {
+            i64 x0;
+            i64 x1;
+            i64 y0;
+            i64 y1;
+        };
+
         bool compare(const E& lhs, const E& rhs) const noexcept
         {
             if constexpr (Swap) {
@@ -139,49 +480,99 @@ namespace dtlx::detail
             }
         }
 
-        i64 snake(i64 k, i64 above, i64 below) const
+        // length of the run of equal elements starting from (x, y) along the diagonal, bounded by x_end and y_end
+        i64 follow_diagonal(i64 x, i64 y, i64 x_end, i64 y_end) const
         {
-            auto y = std::max(above, below);
-            auto x = y - k;
+            if constexpr (BytewiseSnake<E, Comp, R1, R2>) {
+                auto size = std::min(x_end - x, y_end - y);
+                if (size <= 0) {
+                    return 0;
+                }
+                auto lhs = std::ranges::data(m_A) + x;
+                auto rhs = std::ranges::data(m_B) + y;
+                if (*lhs != *rhs) {
+                    return 0;    // most snakes stop right away, skip the vector setup for them
+                }
+                return static_cast<i64>(common_run(lhs, rhs, static_cast<std::size_t>(size)));
+            } else {
+                using I1 = std::ranges::range_difference_t<Subrange1>;
+                using I2 = std::ranges::range_difference_t<Subrange2>;
+
+                auto start = x;
+                while (x < x_end and y < y_end
+                       and compare(m_A[static_cast<I1>(x)], m_B[static_cast<I2>(y)])) {
+                    ++x;
+                    ++y;
+                }
+                return x - start;
+            }
+        }
 
+        // length of the run of equal elements ending right before (x, y), bounded by x_begin and y_begin
+        i64 follow_diagonal_reverse(i64 x, i64 y, i64 x_begin, i64 y_begin) const
+        {
             using I1 = std::ranges::range_difference_t<Subrange1>;
             using I2 = std::ranges::range_difference_t<Subrange2>;
 
-            while (x < m_M and y < m_N and compare(m_A[static_cast<I1>(x)], m_B[static_cast<I2>(y)])) {
-                ++x;
-                ++y;
+            auto end = x;
+            while (x > x_begin and y > y_begin
+                   and compare(m_A[static_cast<I1>(x - 1)], m_B[static_cast<I2>(y - 1)])) {
+                --x;
+                --y;
             }
+            return end - x;
+        }
+
+        i64 snake(i64 k, i64 above, i64 below) const
+        {
+            auto y = std::max(above, below);
+            auto x = y - k;
+
+            auto len = follow_diagonal(x, y, m_M, m_N);
+            x += len;
+            y += len;
 
             return y;
         }
 
-        i64 snake_record(EditPath& path, EditPathCoords<KPoint>& path_coords, i64 k, i64 above, i64 below)
+        // whether every index of the O(NP) loop fits in i32: the furthest points and edit path are bounded by
+        // M + N, the coordinates by max_coords_size plus the last round, which records at most M + N + 1
+        bool fits_i32(u64 max_coords_size) const noexcept
+        {
+            constexpr auto max = static_cast<u64>(std::numeric_limits<i32>::max());
+
+            auto size = static_cast<u64>(m_M + m_N + 3);
+            return size <= max and max_coords_size <= max - size;
+        }
+
+        template <std::signed_integral I>
+        i64 snake_record(EditPath<I>& path, EditPathCoords<KPoint<I>>& path_coords, i64 k, i64 above, i64 below)
             const
         {
             auto r = above > below ? path.at(k - 1 + m_offset) : path.at(k + 1 + m_offset);
             auto y = std::max(above, below);
             auto x = y - k;
 
-            using I1 = std::ranges::range_difference_t<Subrange1>;
-            using I2 = std::ranges::range_difference_t<Subrange2>;
-
-            while (x < m_M and y < m_N and compare(m_A[static_cast<I1>(x)], m_B[static_cast<I2>(y)])) {
-                ++x;
-                ++y;
-            }
+            auto len = follow_diagonal(x, y, m_M, m_N);
+            x += len;
+            y += len;
 
-            path.at(k + m_offset) = static_cast<i64>(path_coords.size());
-            path_coords.add({ x, y, r });
+            path.at(k + m_offset) = static_cast<I>(path_coords.size());
+            path_coords.add({ static_cast<I>(x), static_cast<I>(y), r });
 
             return y;
         }
 
-        i64 calculate_edit_distance(std::span<i64> furthest_points) const
+        // the edit distance is m_delta + 2 * p, gives up once p would exceed max_p
+        std::optional<i64> calculate_edit_distance(std::span<i64> furthest_points, i64 max_p) const
         {
             auto fp = [&](i64 loc) -> i64& { return furthest_points[static_cast<u64>(loc + m_offset)]; };
 
             i64 p = -1;
             do {
+                if (p == max_p) {
+                    return std::nullopt;
+                }
                 ++p;
 
                 for (i64 k = -p; k <= m_delta - 1; ++k) {
@@ -197,37 +588,113 @@ namespace dtlx::detail
             return m_delta + 2 * p;
         }
 
-        i64 record_edits(
-            std::span<i64>          furthest_points,
-            EditPath&               path,
-            EditPathCoords<KPoint>& path_coords,
-            u64                     limit
+        // run the O(NP) loop segment by segment until the end of both sequences is reached
+        template <typename Out, std::signed_integral I>
+        i64 record_segments(
+            Out&                      out,
+            OnpLimits                 limits,
+            bool                      reserve_first,
+            DiffWorkspace::Lease<I>&& buffers
         )
         {
-            auto fp = [&](i64 loc) -> i64& { return furthest_points[static_cast<u64>(loc + m_offset)]; };
+            if (reserve_first and limits.max_coords_size != constants::no_limit) {
+                buffers->path_coords.inner.reserve(limits.max_coords_size);
+            }
+
+            auto edit_distance = i64{ 0 };
+
+            while (true) {
+                auto [distance, complete] = record_segment(out, limits, *buffers);
+                edit_distance             += distance;
+
+                if (complete) {
+                    break;
+                }
+            }
+
+            return edit_distance;
+        }
+
+        // run the O(NP) loop once, up to the end of both sequences or the limits, and move the state past the
+        // recorded part; returns the edit distance of the part and whether the end was reached
+        template <typename Out, std::signed_integral I>
+        std::pair<i64, bool> record_segment(Out& out, OnpLimits limits, OnpBuffers<I>& buffers)
+        {
+            auto& [furthest_points, path, path_coords, reduced_path_coords] = buffers;
+
+            furthest_points.assign(static_cast<u64>(m_M + m_N + 3), -1);
+            path.inner.assign(static_cast<u64>(m_M + m_N + 3), -1);
+
+            path_coords.clear();
+            reduced_path_coords.clear();
+
+            auto [distance, k] = record_edits(furthest_points, path, path_coords, limits);
+
+            auto r = path.at(k + m_offset);
+            while (r != -1) {
+                auto [x, y, k] = path_coords.at(r);
+                reduced_path_coords.add(Point<I>{ x, y });
+                r = k;
+            }
+
+            auto status = record_sequence(out, reduced_path_coords);
+            if (status.is_complete()) {
+                return { distance, true };
+            }
+
+            auto [new_A, new_B, new_ox, new_oy] = std::move(status).as_incomplete();
+            init_state(new_A, new_B, new_ox, new_oy);
+
+            return { distance, false };
+        }
+
+        // returns the edit distance of the recorded path and the diagonal it ends on
+        template <std::signed_integral I>
+        std::pair<i64, i64> record_edits(
+            std::vector<I>&            furthest_points,
+            EditPath<I>&               path,
+            EditPathCoords<KPoint<I>>& path_coords,
+            OnpLimits                  limits
+        )
+        {
+            auto fp = [&](i64 loc) -> I& { return furthest_points[static_cast<u64>(loc + m_offset)]; };
+
+            // at least one round is needed to move off the starting point
+            auto max_p = static_cast<i64>(std::min(std::max(limits.max_cost, u64{ 1 }), static_cast<u64>(m_M)));
 
             i64 p = -1;
             do {
                 ++p;
 
                 for (i64 k = -p; k <= m_delta - 1; ++k) {
-                    fp(k) = snake_record(path, path_coords, k, fp(k - 1) + 1, fp(k + 1));
+                    fp(k) = static_cast<I>(snake_record(path, path_coords, k, fp(k - 1) + 1, fp(k + 1)));
                 }
                 for (i64 k = m_delta + p; k >= m_delta + 1; --k) {
-                    fp(k) = snake_record(path, path_coords, k, fp(k - 1) + 1, fp(k + 1));
+                    fp(k) = static_cast<I>(snake_record(path, path_coords, k, fp(k - 1) + 1, fp(k + 1)));
                 }
-                fp(m_delta) = snake_record(path, path_coords, m_delta, fp(m_delta - 1) + 1, fp(m_delta + 1));
+                auto end    = snake_record(path, path_coords, m_delta, fp(m_delta - 1) + 1, fp(m_delta + 1));
+                fp(m_delta) = static_cast<I>(end);
 
-            } while (fp(m_delta) != m_N and path_coords.size() < limit);
+            } while (fp(m_delta) != m_N and path_coords.size() < limits.max_coords_size and p < max_p);
 
-            return m_delta + 2 * p;
+            if (fp(m_delta) == m_N or p < max_p) {
+                return { m_delta + 2 * p, m_delta };
+            }
+
+            // out of budget: continue from the point that got the furthest (x + y), only diagonals up to m_delta
+            // are considered so that the rest of A stays no longer than the rest of B
+            auto best = m_delta;
+            for (i64 k = -p; k < m_delta; ++k) {
+                if (2 * i64{ fp(k) } - k > 2 * i64{ fp(best) } - best) {
+                    best = k;
+                }
+            }
+
+            return { best + 2 * p, best };
         }
 
-        RecordSequenceStatus record_sequence(
-            Lcs<E>&                      lcs,
-            Ses<E>&                      ses,
-            const EditPathCoords<Point>& path_coords
-        ) const
+        template <typename Out, std::signed_integral I>
+        RecordSequenceStatus record_sequence(Out& out, const EditPathCoords<Point<I>>& path_coords) const
         {
             auto x = m_A.begin();
             auto y = m_B.begin();
@@ -248,31 +715,17 @@ namespace dtlx::detail
                     auto cmp = lhs <=> rhs;
 
                     if (cmp == std::strong_ordering::greater) {
-                        if constexpr (not Swap) {
-                            ses.add(*y, 0, y_idx + m_oy, SesEdit::Add);
-                        } else {
-                            ses.add(*y, y_idx + m_oy, 0, SesEdit::Delete);
-                        }
+                        record_only_b(out, *y, y_idx + m_oy);
                         ++y;
                         ++y_idx;
                         ++py_idx;
                     } else if (cmp == std::strong_ordering::less) {
-                        if constexpr (not Swap) {
-                            ses.add(*x, x_idx + m_ox, 0, SesEdit::Delete);
-                        } else {
-                            ses.add(*x, 0, x_idx + m_ox, SesEdit::Add);
-                        }
+                        record_only_a(out, *x, x_idx + m_ox);
                         ++x;
                         ++x_idx;
                         ++px_idx;
                     } else {
-                        if constexpr (not Swap) {
-                            lcs.add(*x);
-                            ses.add(*x, x_idx + m_ox, y_idx + m_oy, SesEdit::Common);
-                        } else {
-                            lcs.add(*y);
-                            ses.add(*y, y_idx + m_oy, x_idx + m_ox, SesEdit::Common);
-                        }
+                        record_both(out, *x, *y, x_idx + m_ox, y_idx + m_oy);
                         ++x;
                         ++y;
                         ++x_idx;
@@ -292,7 +745,531 @@ namespace dtlx::detail
             auto new_A = Subrange1{ m_A.begin() + x_idx - 1, m_A.end() };
             auto new_B = Subrange2{ m_B.begin() + y_idx - 1, m_B.end() };
 
-            return RecordSequenceStatus::incomplete(new_A, new_B, x_idx - 1, y_idx - 1);
+            return RecordSequenceStatus::incomplete(new_A, new_B, m_ox + x_idx - 1, m_oy + y_idx - 1);
+        }
+
+        // record an element that only exists in A, idx is 1-based and already offset
+        template <typename Out>
+        void record_only_a(Out& out, const E& elem, i64 idx) const
+        {
+            if constexpr (not Swap) {
+                out.add(elem, idx, 0, SesEdit::Delete);
+            } else {
+                out.add(elem, 0, idx, SesEdit::Add);
+            }
+        }
+
+        // record an element that only exists in B, idx is 1-based and already offset
+        template <typename Out>
+        void record_only_b(Out& out, const E& elem, i64 idx) const
+        {
+            if constexpr (not Swap) {
+                out.add(elem, 0, idx, SesEdit::Add);
+            } else {
+                out.add(elem, idx, 0, SesEdit::Delete);
+            }
+        }
+
+        // record an element that exists in both A and B, indices are 1-based and already offset
+        template <typename Out>
+        void record_both(Out& out, const E& a, const E& b, i64 x_idx, i64 y_idx) const
+        {
+            if constexpr (not Swap) {
+                out.add(a, x_idx, y_idx, SesEdit::Common);
+            } else {
+                out.add(b, y_idx, x_idx, SesEdit::Common);
+            }
+        }
+
+        // record len common elements at once, indices of the first are 1-based and already offset
+        template <RunRecordable Out>
+        void record_common_run(Out& out, i64 x_idx, i64 y_idx, i64 len) const
+        {
+            if constexpr (not Swap) {
+                out.add_common(x_idx, y_idx, len);
+            } else {
+                out.add_common(y_idx, x_idx, len);
+            }
+        }
+
+        template <typename Out>
+        void record_common(Out& out, Subrange1 A, Subrange2 B, i64 ox, i64 oy) const
+        {
+            assert(std::ranges::size(A) == std::ranges::size(B));
+
+            if constexpr (RunRecordable<Out>) {
+                record_common_run(out, ox + 1, oy + 1, static_cast<i64>(std::ranges::size(A)));
+                return;
+            }
+
+            auto x = A.begin();
+            auto y = B.begin();
+
+            for (i64 idx = 1; x != A.end(); ++x, ++y, ++idx) {
+                record_both(out, *x, *y, idx + ox, idx + oy);
+            }
+        }
+
+        // strip the common prefix (and suffix if requested) off the state so that only the middle goes
+        // through the O(NP) loop, the stripped parts are kept to be re-emitted as common elements afterwards.
+        //
+        // stripping the prefix does not change the resulting SES since the first snake always follows it, but
+        // stripping the suffix may place the commons differently (still minimal) from what dtl produces
+        void trim_state(bool trim_suffix)
+        {
+            auto head = follow_diagonal(0, 0, m_M, m_N);
+
+            auto tail = trim_suffix ? follow_diagonal_reverse(m_M, m_N, head, head) : 0;
+
+            auto A = m_A;
+            auto B = m_B;
+
+            m_head_A = Subrange1{ A.begin(), A.begin() + head };
+            m_head_B = Subrange2{ B.begin(), B.begin() + head };
+            m_tail_A = Subrange1{ A.begin() + (m_M - tail), A.end() };
+            m_tail_B = Subrange2{ B.begin() + (m_N - tail), B.end() };
+
+            m_head_ox = m_ox;
+            m_head_oy = m_oy;
+            m_tail_ox = m_ox + m_M - tail;
+            m_tail_oy = m_oy + m_N - tail;
+
+            init_state(
+                Subrange1{ A.begin() + head, A.begin() + (m_M - tail) },
+                Subrange2{ B.begin() + head, B.begin() + (m_N - tail) },
+                m_ox + head,
+                m_oy + head
+            );
+        }
+
+        // edit distance of the whole (untrimmed) sequences given their LCS
+        template <typename Out>
+        i64 edit_distance_from(const Out& out) const
+        {
+            auto total_M = m_tail_ox + static_cast<i64>(std::ranges::size(m_tail_A)) - m_head_ox;
+            auto total_N = m_tail_oy + static_cast<i64>(std::ranges::size(m_tail_B)) - m_head_oy;
+
+            return total_M + total_N - 2 * out.lcs_size();
+        }
+
+        // record len elements along the diagonal starting from (x, y) as common
+        template <typename Out>
+        void record_diagonal(Out& out, i64 x, i64 y, i64 len) const
+        {
+            if constexpr (RunRecordable<Out>) {
+                record_common_run(out, x + 1 + m_ox, y + 1 + m_oy, len);
+                return;
+            }
+
+            using I1 = std::ranges::range_difference_t<Subrange1>;
+            using I2 = std::ranges::range_difference_t<Subrange2>;
+
+            for (i64 i = 0; i < len; ++i) {
+                const auto& a = m_A[static_cast<I1>(x + i)];
+                const auto& b = m_B[static_cast<I2>(y + i)];
+                record_both(out, a, b, x + i + 1 + m_ox, y + i + 1 + m_oy);
+            }
+        }
+
+        // record every element of the box as deleted from A then added from B
+        template <typename Out>
+        void record_no_common(Out& out, Box box) const
+        {
+            using I1 = std::ranges::range_difference_t<Subrange1>;
+            using I2 = std::ranges::range_difference_t<Subrange2>;
+
+            for (auto x = box.x0; x < box.x1; ++x) {
+                record_only_a(out, m_A[static_cast<I1>(x)], x + 1 + m_ox);
+            }
+            for (auto y = box.y0; y < box.y1; ++y) {
+                record_only_b(out, m_B[static_cast<I2>(y)], y + 1 + m_oy);
+            }
+        }
+
+        template <typename Out>
+        void linear_solve(Out& out, Box box, ThreadPool* pool, u64 min_task_size) const
+        {
+            auto [x0, x1, y0, y1] = box;
+
+            auto head = follow_diagonal(x0, y0, x1, y1);
+            record_diagonal(out, x0, y0, head);
+            x0 += head;
+            y0 += head;
+
+            auto tail = follow_diagonal_reverse(x1, y1, x0, y0);
+            x1 -= tail;
+            y1 -= tail;
+
+            auto split = x0 == x1 or y0 == y1 ? std::nullopt : linear_split({ x0, x1, y0, y1 });
+
+            if (not split) {
+                record_no_common(out, { x0, x1, y0, y1 });    // nothing in common (or one side is empty)
+            } else {
+                assert(*split != (Point<>{ x0, y0 }) and *split != (Point<>{ x1, y1 }));
+
+                auto left  = Box{ x0, split->x, y0, split->y };
+                auto right = Box{ split->x, x1, split->y, y1 };
+
+                auto right_size = static_cast<u64>((x1 - split->x) + (y1 - split->y));
+
+                if (pool != nullptr and right_size >= min_task_size) {
+                    auto future = pool->submit([this, right, pool, min_task_size, part = out.part()]() mutable {
+                        linear_solve(part, right, pool, min_task_size);
+                        return std::move(part);
+                    });
+
+                    linear_solve(out, left, pool, min_task_size);
+                    out.append(pool->wait(future));
+                } else {
+                    linear_solve(out, left, pool, min_task_size);
+                    linear_solve(out, right, pool, min_task_size);
+                }
+            }
+
+            record_diagonal(out, x1, y1, tail);
+        }
+
+        // find a point on an optimal path by running the search from both ends until the paths overlap,
+        // the point splits the box into two independent halves; returns nullopt if nothing is in common
+        std::optional<Point<>> linear_split(Box box) const
+        {
+            auto [x0, x1, y0, y1] = box;
+
+            const auto n = x1 - x0;
+            const auto m = y1 - y0;
+
+            const auto max_d  = (n + m + 1) / 2;
+            const auto offset = max_d;
+            const auto length = 2 * max_d + 2;
+
+            auto forward  = std::vector<i64>(static_cast<u64>(length), -1);
+            auto backward = std::vector<i64>(static_cast<u64>(length), -1);
+
+            auto fw = [&](i64 k) -> i64& { return forward[static_cast<u64>(k + offset)]; };
+            auto bw = [&](i64 k) -> i64& { return backward[static_cast<u64>(k + offset)]; };
+
+            fw(1) = 0;
+            bw(1) = 0;
+
+            const auto delta = n - m;
+            const auto front = delta % 2 != 0;    // odd delta: forward path detects the overlap
+
+            // bounds of the diagonals that have not run off the grid
+            i64 fw_start = 0;
+            i64 fw_end   = 0;
+            i64 bw_start = 0;
+            i64 bw_end   = 0;
+
+            auto in_range = [&](i64 k) { return k + offset >= 0 and k + offset < length; };
+
+            for (i64 d = 0; d < max_d; ++d) {
+                for (i64 k = -d + fw_start; k <= d - fw_end; k += 2) {
+                    auto x = (k == -d or (k != d and fw(k - 1) < fw(k + 1))) ? fw(k + 1) : fw(k - 1) + 1;
+                    x += follow_diagonal(x0 + x, y0 + x - k, x1, y1);
+
+                    auto y = x - k;
+                    fw(k)  = x;
+
+                    if (x > n) {
+                        fw_end += 2;
+                    } else if (y > m) {
+                        fw_start += 2;
+                    } else if (front and in_range(delta - k) and bw(delta - k) != -1) {
+                        if (x >= n - bw(delta - k)) {
+                            return Point<>{ x0 + x, y0 + y };
+                        }
+                    }
+                }
+
+                for (i64 k = -d + bw_start; k <= d - bw_end; k += 2) {
+                    auto x = (k == -d or (k != d and bw(k - 1) < bw(k + 1))) ? bw(k + 1) : bw(k - 1) + 1;
+                    x += follow_diagonal_reverse(x1 - x, y1 - x + k, x0, y0);
+
+                    auto y = x - k;
+                    bw(k)  = x;
+
+                    if (x > n) {
+                        bw_end += 2;
+                    } else if (y > m) {
+                        bw_start += 2;
+                    } else if (not front and in_range(delta - k) and fw(delta - k) != -1) {
+                        auto fx = fw(delta - k);
+                        if (fx >= n - x) {
+                            return Point<>{ x0 + fx, y0 + fx - (delta - k) };
+                        }
+                    }
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        // run the O(NP) algorithm on the box alone, the shorter side becomes A as the algorithm requires
+        template <typename Out>
+        void onp_solve(Out& out, Box box, OnpLimits limits, DiffWorkspace& workspace) const
+        {
+            auto [x0, x1, y0, y1] = box;
+
+            if (x0 == x1 or y0 == y1) {
+                record_no_common(out, box);
+                return;
+            }
+
+            auto A = Subrange1{ m_A.begin() + x0, m_A.begin() + x1 };
+            auto B = Subrange2{ m_B.begin() + y0, m_B.begin() + y1 };
+
+            if (x1 - x0 <= y1 - y0) {
+                auto sub = Diff<E, Comp, Subrange1, Subrange2, Swap>{ A, B, m_comp, m_ox + x0, m_oy + y0 };
+                sub.record_diff(out, limits, false, false, workspace);
+            } else {
+                auto sub = Diff<E, Comp, Subrange2, Subrange1, not Swap>{ B, A, m_comp, m_oy + y0, m_ox + x0 };
+                sub.record_diff(out, limits, false, false, workspace);
+            }
+        }
+
+        template <typename Out>
+        void patience_solve(Out& out, Box box, OnpLimits limits, DiffWorkspace& workspace) const
+        {
+            auto [x0, x1, y0, y1] = box;
+
+            auto head = follow_diagonal(x0, y0, x1, y1);
+            record_diagonal(out, x0, y0, head);
+            x0 += head;
+            y0 += head;
+
+            auto tail = follow_diagonal_reverse(x1, y1, x0, y0);
+            x1 -= tail;
+            y1 -= tail;
+
+            auto anchors = x0 == x1 or y0 == y1 ? std::vector<Point<>>{} : unique_anchors({ x0, x1, y0, y1 });
+
+            if (anchors.empty()) {
+                onp_solve(out, { x0, x1, y0, y1 }, limits, workspace);
+            } else {
+                auto x = x0;
+                auto y = y0;
+                for (auto anchor : anchors) {
+                    patience_solve(out, { x, anchor.x, y, anchor.y }, limits, workspace);
+                    record_diagonal(out, anchor.x, anchor.y, 1);
+                    x = anchor.x + 1;
+                    y = anchor.y + 1;
+                }
+                patience_solve(out, { x, x1, y, y1 }, limits, workspace);
+            }
+
+            record_diagonal(out, x1, y1, tail);
+        }
+
+        template <typename Out>
+        void histogram_solve(Out& out, Box box, OnpLimits limits, DiffWorkspace& workspace) const
+        {
+            auto [x0, x1, y0, y1] = box;
+
+            auto head = follow_diagonal(x0, y0, x1, y1);
+            record_diagonal(out, x0, y0, head);
+            x0 += head;
+            y0 += head;
+
+            auto tail = follow_diagonal_reverse(x1, y1, x0, y0);
+            x1 -= tail;
+            y1 -= tail;
+
+            auto region = x0 == x1 or y0 == y1 ? std::nullopt : histogram_split({ x0, x1, y0, y1 });
+
+            if (not region) {
+                onp_solve(out, { x0, x1, y0, y1 }, limits, workspace);
+            } else {
+                histogram_solve(out, { x0, region->x0, y0, region->y0 }, limits, workspace);
+                record_diagonal(out, region->x0, region->y0, region->x1 - region->x0);
+                histogram_solve(out, { region->x1, x1, region->y1, y1 }, limits, workspace);
+            }
+
+            record_diagonal(out, x1, y1, tail);
+        }
+
+        // find the common run whose least frequent element (in A) occurs the least, preferring longer runs;
+        // returns nullopt if every common element occurs more than constants::histogram_max_occurrences
+        std::optional<Box> histogram_split(Box box) const
+            requires HashGroupable<E, Comp>
+        {
+            constexpr auto max_occurrences = static_cast<i64>(constants::histogram_max_occurrences);
+
+            struct Occurrence
+            {
+                i64 count  = 0;
+                i64 last_x = -1;    // last position in A, the previous ones are chained through prev_x
+            };
+
+            auto hash = [this](i64 key) { return with_elem(key, std::hash<E>{}); };
+            auto eq   = [this](i64 lhs, i64 rhs) {
+                return with_elem(lhs, [&](const E& l) {
+                    return with_elem(rhs, [&](const E& r) { return m_comp(l, r); });
+                });
+            };
+
+            auto occurrences = std::unordered_map<i64, Occurrence, decltype(hash), decltype(eq)>{
+                static_cast<std::size_t>(box.x1 - box.x0), hash, eq
+            };
+
+            auto prev_x = std::vector<i64>(static_cast<u64>(box.x1 - box.x0), -1);
+
+            for (auto x = box.x0; x < box.x1; ++x) {
+                auto& occurrence = occurrences.try_emplace(x).first->second;
+                ++occurrence.count;
+                prev_x[static_cast<u64>(x - box.x0)] = occurrence.last_x;
+                occurrence.last_x                    = x;
+            }
+
+            auto best       = std::optional<Box>{};
+            auto best_count = max_occurrences;
+
+            for (auto y = box.y0; y < box.y1;) {
+                auto next_y = y + 1;
+
+                auto it = occurrences.find(~y);
+                if (it == occurrences.end() or it->second.count > best_count) {
+                    y = next_y;
+                    continue;
+                }
+
+                for (auto x = it->second.last_x; x != -1; x = prev_x[static_cast<u64>(x - box.x0)]) {
+                    auto count = it->second.count;
+
+                    auto rx0 = x;
+                    auto ry0 = y;
+                    while (rx0 > box.x0 and ry0 > box.y0 and eq(rx0 - 1, ~(ry0 - 1))) {
+                        --rx0;
+                        --ry0;
+                        count = std::min(count, occurrences.find(rx0)->second.count);
+                    }
+
+                    auto rx1 = x + 1;
+                    auto ry1 = y + 1;
+                    while (rx1 < box.x1 and ry1 < box.y1 and eq(rx1, ~ry1)) {
+                        count = std::min(count, occurrences.find(rx1)->second.count);
+                        ++rx1;
+                        ++ry1;
+                    }
+
+                    if (not best or rx1 - rx0 > best->x1 - best->x0 or count < best_count) {
+                        best       = Box{ rx0, rx1, ry0, ry1 };
+                        best_count = count;
+                    }
+
+                    next_y = std::max(next_y, ry1);
+                }
+
+                y = next_y;
+            }
+
+            return best;
+        }
+
+        // split the box on anchors into segments of at least min_segment_size (both sides combined) elements,
+        // an anchor sits right after the end of each segment except the last one
+        std::vector<Box> anchored_segments(Box box, u64 min_segment_size) const
+            requires HashGroupable<E, Comp>
+        {
+            auto segments = std::vector<Box>{};
+
+            auto x = box.x0;
+            auto y = box.y0;
+
+            for (auto anchor : unique_anchors(box)) {
+                if (static_cast<u64>((anchor.x - x) + (anchor.y - y)) >= min_segment_size) {
+                    segments.push_back({ x, anchor.x, y, anchor.y });
+                    x = anchor.x + 1;
+                    y = anchor.y + 1;
+                }
+            }
+            segments.push_back({ x, box.x1, y, box.y1 });
+
+            return segments;
+        }
+
+        // call fn with the element identified by key: A[key] if key >= 0, B[~key] otherwise
+        template <typename Fn>
+        decltype(auto) with_elem(i64 key, Fn&& fn) const
+        {
+            using I1 = std::ranges::range_difference_t<Subrange1>;
+            using I2 = std::ranges::range_difference_t<Subrange2>;
+
+            return key >= 0 ? fn(m_A[static_cast<I1>(key)]) : fn(m_B[static_cast<I2>(~key)]);
+        }
+
+        // elements that occur exactly once in both sides of the box, reduced to the longest sequence of them
+        // that is increasing on both sides (LIS); these are matched in the final SES
+        std::vector<Point<>> unique_anchors(Box box) const
+            requires HashGroupable<E, Comp>
+        {
+            struct Occurrence
+            {
+                i64 count_a = 0;
+                i64 count_b = 0;
+                i64 x       = 0;
+                i64 y       = 0;
+            };
+
+            // the keys refer to the elements themselves so that nothing is copied
+            auto hash = [this](i64 key) { return with_elem(key, std::hash<E>{}); };
+            auto eq   = [this](i64 lhs, i64 rhs) {
+                return with_elem(lhs, [&](const E& l) {
+                    return with_elem(rhs, [&](const E& r) { return m_comp(l, r); });
+                });
+            };
+
+            auto occurrences = std::unordered_map<i64, Occurrence, decltype(hash), decltype(eq)>{
+                static_cast<std::size_t>(box.x1 - box.x0), hash, eq
+            };
+
+            for (auto x = box.x0; x < box.x1; ++x) {
+                auto& occurrence = occurrences.try_emplace(x).first->second;
+                ++occurrence.count_a;
+                occurrence.x = x;
+            }
+            for (auto y = box.y0; y < box.y1; ++y) {
+                if (auto it = occurrences.find(~y); it != occurrences.end()) {
+                    ++it->second.count_b;
+                    it->second.y = y;
+                }
+            }
+
+            auto uniques = std::vector<Point<>>{};
+            for (const auto& [_, occurrence] : occurrences) {
+                if (occurrence.count_a == 1 and occurrence.count_b == 1) {
+                    uniques.push_back({ occurrence.x, occurrence.y });
+                }
+            }
+            std::ranges::sort(uniques, {}, &Point<>::x);
+
+            // patience sorting: piles hold the index of the top card, prev links each card to the pile on its left
+            auto piles = std::vector<std::size_t>{};
+            auto prev  = std::vector<std::size_t>(uniques.size());
+
+            for (std::size_t i = 0; i < uniques.size(); ++i) {
+                auto pile = std::ranges::lower_bound(piles, uniques[i].y, {}, [&](std::size_t top) {
+                    return uniques[top].y;
+                });
+                if (pile != piles.begin()) {
+                    prev[i] = *(pile - 1);
+                }
+                if (pile == piles.end()) {
+                    piles.push_back(i);
+                } else {
+                    *pile = i;
+                }
+            }
+
+            auto anchors = std::vector<Point<>>(piles.size());
+            if (not piles.empty()) {
+                auto card = piles.back();
+                for (auto i = anchors.size(); i > 0; --i) {
+                    anchors[i - 1] = uniques[card];
+                    card           = prev[card];
+                }
+            }
+
+            return anchors;
         }
 
         void init_state(Subrange1 A, Subrange2 B, i64 ox, i64 oy)
@@ -315,6 +1292,16 @@ namespace dtlx::detail
         Subrange1 m_A;
         Subrange2 m_B;
 
+        Subrange1 m_head_A;    // common prefix stripped by trim_state
+        Subrange2 m_head_B;
+        Subrange1 m_tail_A;    // common suffix stripped by trim_state
+        Subrange2 m_tail_B;
+
+        i64 m_head_ox = 0;    // offsets of the stripped parts
+        i64 m_head_oy = 0;
+        i64 m_tail_ox = 0;
+        i64 m_tail_oy = 0;
+
         i64 m_M = 0;
         i64 m_N = 0;
 
@@ -324,6 +1311,9 @@ namespace dtlx::detail
         i64 m_ox = 0;
         i64 m_oy = 0;
 
+        std::vector<Box> m_segments;    // split by record_anchored_head
+        std::size_t      m_next_segment = 0;
+
         [[no_unique_address]] Comp m_comp;
     };
 }
@@ -4,7 +4,17 @@
 #include "dtlx/concepts.hpp"
 #include "dtlx/detail/diff.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace dtlx::detail
 {
@@ -47,6 +57,93 @@ namespace dtlx::detail
         return MergeResult<E, Cont>{ typename MergeResult<E, Cont>::Merge{ std::move(merged) } };
     }
 
+    /**
+     * @struct IndexRange
+     *
+     * @brief Range of 0-based indices `[begin, end)` into a sequence.
+     */
+    struct IndexRange
+    {
+        i64 begin = 0;
+        i64 end   = 0;
+
+        i64  size() const { return end - begin; }
+        bool empty() const { return begin == end; }
+
+        /**
+         * @brief View of the elements of `range` in this index range.
+         */
+        template <std::ranges::random_access_range R>
+        auto view(R&& range) const
+        {
+            auto first = std::ranges::begin(range) + static_cast<std::ranges::range_difference_t<R>>(begin);
+            return std::ranges::subrange(first, first + static_cast<std::ranges::range_difference_t<R>>(size()));
+        }
+
+        bool operator==(const IndexRange&) const = default;
+    };
+
+    /**
+     * @struct ConflictRegion
+     *
+     * @brief Part of a merge where the two sides changed the base differently.
+     */
+    struct ConflictRegion
+    {
+        i64        position;    // index in the merged sequence the region goes before
+        IndexRange base;        // elements of the base (the second range)
+        IndexRange ours;        // elements of the first range
+        IndexRange theirs;      // elements of the third range
+
+        bool operator==(const ConflictRegion&) const = default;
+    };
+
+    /**
+     * @struct MultiConflictRegion
+     *
+     * @brief Part of a merge of many ranges against a base where they changed the base differently.
+     */
+    struct MultiConflictRegion
+    {
+        i64                     position;    // index in the merged sequence the region goes before
+        IndexRange              base;        // elements of the base
+        std::vector<IndexRange> sides;       // elements of each of the merged ranges, in their order
+
+        bool operator==(const MultiConflictRegion&) const = default;
+    };
+
+    /**
+     * @brief The result of merge algorithm that goes on past conflicts.
+     *
+     * The merged sequence holds everything that merged cleanly, each conflict region is left out of it and
+     * recorded at the position it would be at instead.
+     */
+    template <Diffable E, template <typename... EInner> typename Cont, typename Region = ConflictRegion>
+    struct [[nodiscard]] MergeRegions
+    {
+        Cont<E>             merged;
+        std::vector<Region> conflicts;
+
+        bool is_conflict() const { return not conflicts.empty(); }
+        bool is_merge() const { return conflicts.empty(); }
+    };
+
+    /**
+     * @struct ConflictMarkers
+     *
+     * @brief Elements written around the sides of a conflict region, e.g. `<<<<<<< ours` for a range of lines.
+     *
+     * The base side is only written if `base` is not empty (the diff3 style of git).
+     */
+    template <Diffable E>
+    struct ConflictMarkers
+    {
+        std::vector<E> ours;         // before the first range, e.g. `<<<<<<< ours`
+        std::vector<E> base;         // before the base, e.g. `||||||| base`
+        std::vector<E> separator;    // before the third range, e.g. `=======`
+        std::vector<E> theirs;       // after the third range, e.g. `>>>>>>> theirs`
+    };
+
     enum class TrivialMergeKind
     {
         AEqualsBEqualsC,
@@ -56,8 +153,8 @@ namespace dtlx::detail
 
     template <Diffable E>
     std::optional<TrivialMergeKind> trivially_mergeable(
-        const DiffResult<E>& diff_ba,
-        const DiffResult<E>& diff_bc
+        const RunDiffResult<E>& diff_ba,
+        const RunDiffResult<E>& diff_bc
     )
     {
         auto ed_ba = diff_ba.edit_distance;
@@ -72,134 +169,563 @@ namespace dtlx::detail
         return std::nullopt;
     }
 
-    template <Diffable E, template <typename... EInner> typename Container, Comparator<E> Comp>
-    MergeResult<E, Container> merge(const DiffResult<E>& diff_ba, const DiffResult<E>& diff_bc, Comp comp)
+    /**
+     * @class RunCursor
+     *
+     * @brief Position in the runs of a SES, moves by any number of elements of the current run.
+     */
+    template <Diffable E>
+    class RunCursor
     {
-        // if a merge is trivial to begin with, this function should not be called
-        assert(trivially_mergeable(diff_ba, diff_bc) == std::nullopt);
+    public:
+        explicit RunCursor(const RunSes<E>& ses)
+            : m_runs{ ses.get() }
+            , m_added{ ses.added().data() }
+        {
+        }
 
-        auto ses_ba = diff_ba.ses.get();
-        auto ses_bc = diff_bc.ses.get();
+        bool    done() const { return m_run == m_runs.size(); }
+        SesEdit type() const { return m_runs[m_run].type; }
+        i64     remaining() const { return m_runs[m_run].length - m_offset; }
 
-        auto ba_it = ses_ba.begin();
-        auto bc_it = ses_bc.begin();
+        // number of elements of the base and of the other side passed so far
+        i64 base_index() const { return m_base; }
+        i64 side_index() const { return m_side; }
 
-        auto ba_end = [&] { return ba_it == ses_ba.end(); };
-        auto bc_end = [&] { return bc_it == ses_bc.end(); };
+        // the added elements of the rest of the run, only valid for added runs
+        const E* added() const { return m_added; }
 
-        auto merged = Container<E>{};
+        void advance(i64 count)
+        {
+            assert(count <= remaining());
 
-        while (not ba_end() or not bc_end()) {
-            while (true) {
-                const auto& [ba_elem, ba_info] = *ba_it;
-                const auto& [bc_elem, bc_info] = *bc_it;
+            if (type() == SesEdit::Add) {
+                m_added += count;
+            }
+            m_base += type() != SesEdit::Add ? count : 0;
+            m_side += type() != SesEdit::Delete ? count : 0;
 
-                if (ba_end() or bc_end()) {
-                    break;
-                }
+            if (m_offset += count; m_offset == m_runs[m_run].length) {
+                ++m_run;
+                m_offset = 0;
+            }
+        }
 
-                auto same_elem      = comp(ba_elem, bc_elem);
-                auto edit_is_common = ba_info.type == SesEdit::Common and bc_info.type == SesEdit::Common;
+    private:
+        std::span<const EditRun> m_runs;
+        std::size_t              m_run    = 0;
+        i64                      m_offset = 0;
+        i64                      m_base   = 0;
+        i64                      m_side   = 0;
+        const E*                 m_added;
+    };
 
-                if (not same_elem or not edit_is_common) {
-                    break;
-                }
+    /**
+     * @class LazyRunCursor
+     *
+     * @brief Position in runs that are read one at a time from an input range, e.g. a `DiffView`.
+     *
+     * The added elements are not stored with the runs, they are looked up in the range the SES leads to.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> Sentinel, std::random_access_iterator Added>
+    class LazyRunCursor
+    {
+    public:
+        LazyRunCursor(It it, Sentinel end, Added target)
+            : m_it{ std::move(it) }
+            , m_end{ std::move(end) }
+            , m_target{ std::move(target) }
+        {
+        }
 
-                if (not ba_end()) {
-                    merged.push_back(ba_elem);
-                } else if (not bc_end()) {
-                    merged.push_back(bc_elem);
-                }
+        bool    done() const { return m_it == m_end; }
+        SesEdit type() const { return (*m_it).type; }
+        i64     remaining() const { return (*m_it).length - m_offset; }
 
-                ++ba_it;
-                ++bc_it;
-            }
+        // number of elements of the base and of the other side passed so far
+        i64 base_index() const { return m_base; }
+        i64 side_index() const { return m_side; }
 
-            if (ba_end() or bc_end()) {
-                break;
+        // the added elements of the rest of the run, only valid for added runs
+        Added added() const
+        {
+            return m_target + static_cast<std::iter_difference_t<Added>>((*m_it).index_after - 1 + m_offset);
+        }
+
+        void advance(i64 count)
+        {
+            assert(count <= remaining());
+
+            m_base += type() != SesEdit::Add ? count : 0;
+            m_side += type() != SesEdit::Delete ? count : 0;
+
+            if (m_offset += count; m_offset == (*m_it).length) {
+                ++m_it;
+                m_offset = 0;
             }
+        }
+
+    private:
+        It       m_it;
+        Sentinel m_end;
+        Added    m_target;
+        i64      m_offset = 0;
+        i64      m_base   = 0;
+        i64      m_side   = 0;
+    };
+
+    // both SES start from the base, the elements deleted or kept by both are at the same place in the base, so
+    // the SES can be walked a whole run at a time. what the merge keeps is passed to `keep_base(count)`,
+    // `skip_base(count)`, and `keep_added(first, count)`. at a conflict `on_conflict()` is called with the
+    // cursors at its start, it either moves them past the conflict and returns true, or the walk returns false
+    template <
+        typename CursorA,
+        typename CursorC,
+        typename Comp,
+        typename KeepBase,
+        typename SkipBase,
+        typename KeepAdded,
+        typename OnConflict>
+    bool walk_merge(
+        CursorA&   ba,
+        CursorC&   bc,
+        Comp       comp,
+        KeepBase   keep_base,
+        SkipBase   skip_base,
+        KeepAdded  keep_added,
+        OnConflict on_conflict
+    )
+    {
+        auto keep_both = [&](i64 count) {
+            keep_base(count);
+            ba.advance(count);
+            bc.advance(count);
+        };
+
+        auto skip_both = [&](i64 count) {
+            skip_base(count);
+            ba.advance(count);
+            bc.advance(count);
+        };
+
+        auto keep_run = [&](auto& cursor) {
+            auto count = cursor.remaining();
+            keep_added(cursor.added(), count);
+            cursor.advance(count);
+        };
 
-            const auto& [ba_elem, ba_info] = *ba_it;
-            const auto& [bc_elem, bc_info] = *bc_it;
+        while (not ba.done() and not bc.done()) {
+            auto count = std::min(ba.remaining(), bc.remaining());
 
-            switch (ba_info.type) {
+            switch (ba.type()) {
             case SesEdit::Common: {
-                switch (bc_info.type) {
-                case SesEdit::Delete: {
-                    ++ba_it;
-                    ++bc_it;
-                } break;
-                case SesEdit::Add: {
-                    merged.push_back(bc_elem);
-                    ++bc_it;
-                } break;
-                case SesEdit::Common: {
-                    [[unlikely]];
-                    assert(false and "unreachable");
-                } break;
+                switch (bc.type()) {
+                case SesEdit::Common: keep_both(count); break;
+                case SesEdit::Delete: skip_both(count); break;
+                case SesEdit::Add: keep_run(bc); break;
                 }
             } break;
             case SesEdit::Delete: {
-                switch (bc_info.type) {
-                case SesEdit::Common: {
-                    ++ba_it;
-                    ++bc_it;
-                } break;
-                case SesEdit::Delete: {
-                    if (comp(ba_elem, bc_elem)) {
-                        ++ba_it;
-                        ++bc_it;
-                    } else {
-                        return create_conflict<E, Container>();
-                    }
-                } break;
+                switch (bc.type()) {
+                case SesEdit::Common:
+                case SesEdit::Delete: skip_both(count); break;
                 case SesEdit::Add: {
-                    return create_conflict<E, Container>();
+                    if (not on_conflict()) {
+                        return false;
+                    }
                 } break;
                 }
             } break;
             case SesEdit::Add: {
-                switch (bc_info.type) {
-                case SesEdit::Common: {
-                    merged.push_back(ba_elem);
-                    ++ba_it;
-                } break;
+                switch (bc.type()) {
+                case SesEdit::Common: keep_run(ba); break;
                 case SesEdit::Delete: {
-                    return create_conflict<E, Container>();
+                    if (not on_conflict()) {
+                        return false;
+                    }
                 } break;
                 case SesEdit::Add: {
-                    if (comp(ba_elem, bc_elem)) {
-                        merged.push_back(ba_elem);
-                        ++ba_it;
-                        ++bc_it;
-                    } else {
-                        return create_conflict<E, Container>();
+                    if (not std::equal(ba.added(), ba.added() + count, bc.added(), comp)) {
+                        if (not on_conflict()) {
+                            return false;
+                        }
+                        break;
                     }
+                    keep_added(ba.added(), count);
+                    ba.advance(count);
+                    bc.advance(count);
                 } break;
                 }
             } break;
             }
         }
 
-        if (ba_end()) {
-            while (not bc_end()) {
-                const auto& [bc_elem, bc_info] = *bc_it;
-                if (bc_info.type == SesEdit::Add) {
-                    merged.push_back(bc_elem);
+        // both SES went through the whole base by now, only additions are left in the unfinished one
+        auto keep_rest = [&](auto& cursor) {
+            while (not cursor.done()) {
+                assert(cursor.type() == SesEdit::Add);
+                keep_run(cursor);
+            }
+        };
+
+        keep_rest(ba);
+        keep_rest(bc);
+
+        return true;
+    }
+
+    template <Diffable E, template <typename... EInner> typename Container, Comparator<E> Comp, typename R>
+    MergeResult<E, Container> merge(
+        const RunDiffResult<E>& diff_ba,
+        const RunDiffResult<E>& diff_bc,
+        R&&                     base,
+        Comp                    comp
+    )
+    {
+        // if a merge is trivial to begin with, this function should not be called
+        assert(trivially_mergeable(diff_ba, diff_bc) == std::nullopt);
+
+        auto ba = RunCursor<E>{ diff_ba.ses };
+        auto bc = RunCursor<E>{ diff_bc.ses };
+
+        auto base_it = std::ranges::begin(base);
+        auto merged  = Container<E>{};
+
+        auto keep_base = [&](i64 count) {
+            auto next = std::ranges::next(base_it, count);
+            merged.insert(merged.end(), base_it, next);
+            base_it = next;
+        };
+
+        auto skip_base  = [&](i64 count) { std::ranges::advance(base_it, count); };
+        auto keep_added = [&](const E* first, i64 count) { merged.insert(merged.end(), first, first + count); };
+
+        auto stop = [] { return false; };
+
+        if (not walk_merge(ba, bc, comp, keep_base, skip_base, keep_added, stop)) {
+            return create_conflict<E, Container>();
+        }
+
+        return create_merge<E, Container>(std::move(merged));
+    }
+
+    // moves the cursors from the start of a conflict to the next place where both keep the same element of the
+    // base, the region spans everything the cursors passed
+    template <typename CursorA, typename CursorC>
+    ConflictRegion skip_conflict(CursorA& ba, CursorC& bc, i64 position)
+    {
+        auto region = ConflictRegion{
+            .position = position,
+            .base     = { ba.base_index(), ba.base_index() },
+            .ours     = { ba.side_index(), ba.side_index() },
+            .theirs   = { bc.side_index(), bc.side_index() },
+        };
+
+        auto at_common = [](auto& cursor) { return cursor.done() or cursor.type() == SesEdit::Common; };
+
+        // the cursor behind only goes up to the other one on a common run, edits are passed a whole run at a time
+        auto step = [](auto& cursor, i64 until) {
+            auto count = cursor.remaining();
+            if (cursor.type() == SesEdit::Common) {
+                count = std::min(count, until - cursor.base_index());
+            }
+            cursor.advance(count);
+        };
+
+        while (true) {
+            auto pos_a = ba.base_index();
+            auto pos_c = bc.base_index();
+
+            if (pos_a < pos_c) {
+                step(ba, pos_c);
+            } else if (pos_c < pos_a) {
+                step(bc, pos_a);
+            } else if (not at_common(ba)) {
+                step(ba, pos_a);
+            } else if (not at_common(bc)) {
+                step(bc, pos_c);
+            } else {
+                break;
+            }
+        }
+
+        region.base.end   = ba.base_index();
+        region.ours.end   = ba.side_index();
+        region.theirs.end = bc.side_index();
+
+        return region;
+    }
+
+    template <Diffable E, template <typename... EInner> typename Container, Comparator<E> Comp, typename R>
+    MergeRegions<E, Container> merge_regions(
+        const RunDiffResult<E>& diff_ba,
+        const RunDiffResult<E>& diff_bc,
+        R&&                     base,
+        Comp                    comp
+    )
+    {
+        auto ba = RunCursor<E>{ diff_ba.ses };
+        auto bc = RunCursor<E>{ diff_bc.ses };
+
+        auto result     = MergeRegions<E, Container>{};
+        auto base_first = std::ranges::begin(base);
+
+        // elements of the base deleted by both sides right before the current position, they belong to the base
+        // side of a conflict that follows
+        auto deleted_by_both = i64{ 0 };
+
+        auto keep_base = [&](i64 count) {
+            auto first = std::ranges::next(base_first, ba.base_index());
+            result.merged.insert(result.merged.end(), first, std::ranges::next(first, count));
+            deleted_by_both = 0;
+        };
+
+        auto skip_base = [&](i64 count) {
+            auto both       = ba.type() == SesEdit::Delete and bc.type() == SesEdit::Delete;
+            deleted_by_both = both ? deleted_by_both + count : 0;
+        };
+
+        auto keep_added = [&](const E* first, i64 count) {
+            result.merged.insert(result.merged.end(), first, first + count);
+            deleted_by_both = 0;
+        };
+
+        auto on_conflict = [&] {
+            auto position = static_cast<i64>(std::ranges::size(result.merged));
+            auto region   = skip_conflict(ba, bc, position);
+
+            region.base.begin -= std::exchange(deleted_by_both, 0);
+            result.conflicts.push_back(region);
+
+            return true;
+        };
+
+        walk_merge(ba, bc, comp, keep_base, skip_base, keep_added, on_conflict);
+
+        return result;
+    }
+
+    // moves all the cursors from the start of a conflict to the next place where they all keep the same element
+    // of the base, the same as `skip_conflict` for any number of them
+    template <typename Cursor>
+    MultiConflictRegion skip_conflict_n(std::span<Cursor> cursors, i64 position)
+    {
+        auto region = MultiConflictRegion{
+            .position = position,
+            .base     = { cursors.front().base_index(), cursors.front().base_index() },
+            .sides    = std::vector<IndexRange>(cursors.size()),
+        };
+
+        for (std::size_t i = 0; i < cursors.size(); ++i) {
+            region.sides[i] = { cursors[i].side_index(), cursors[i].side_index() };
+        }
+
+        auto at_common = [](Cursor& cursor) { return cursor.done() or cursor.type() == SesEdit::Common; };
+        auto by_base   = [](Cursor& cursor) { return cursor.base_index(); };
+
+        auto step = [](Cursor& cursor, i64 until) {
+            auto count = cursor.remaining();
+            if (cursor.type() == SesEdit::Common) {
+                count = std::min(count, until - cursor.base_index());
+            }
+            cursor.advance(count);
+        };
+
+        while (true) {
+            auto [behind, ahead] = std::ranges::minmax_element(cursors, {}, by_base);
+            auto until           = ahead->base_index();
+
+            if (behind->base_index() < until) {
+                step(*behind, until);
+            } else if (auto changed = std::ranges::find_if_not(cursors, at_common); changed != cursors.end()) {
+                step(*changed, until);
+            } else {
+                break;
+            }
+        }
+
+        region.base.end = cursors.front().base_index();
+        for (std::size_t i = 0; i < cursors.size(); ++i) {
+            region.sides[i].end = cursors[i].side_index();
+        }
+
+        return region;
+    }
+
+    // the same walk as `walk_merge` over the SES of the base against any number of ranges at once: the added
+    // runs of the ranges that add at the same place must be the same, and no other range may delete there
+    template <
+        Diffable E,
+        template <typename... EInner> typename Container,
+        typename Cursor,
+        typename R,
+        typename Comp>
+    MergeRegions<E, Container, MultiConflictRegion> merge_n(std::span<Cursor> cursors, R&& base, Comp comp)
+    {
+        auto result     = MergeRegions<E, Container, MultiConflictRegion>{};
+        auto base_first = std::ranges::begin(base);
+
+        // nothing changed the base
+        if (cursors.empty()) {
+            result.merged.insert(result.merged.end(), base_first, std::ranges::end(base));
+            return result;
+        }
+
+        // the steps since the last element written, where some ranges deleted and the others kept the base: where
+        // each step started in the base and in every range, and which ranges deleted in it
+        auto skipped_base    = std::vector<i64>{};
+        auto skipped_sides   = std::vector<i64>{};
+        auto skipped_deletes = std::vector<bool>{};
+
+        auto clear_skipped = [&] {
+            skipped_base.clear();
+            skipped_sides.clear();
+            skipped_deletes.clear();
+        };
+
+        auto advance_all = [&](i64 count) {
+            for (auto& cursor : cursors) {
+                cursor.advance(count);
+            }
+        };
+
+        // the region also spans the steps right before it where every range that takes part in the conflict
+        // deleted, each side from where it was at the first of them so that all of them cover the same base
+        auto on_conflict = [&] {
+            auto position   = static_cast<i64>(std::ranges::size(result.merged));
+            auto takes_part = std::vector<bool>(cursors.size());
+
+            for (std::size_t i = 0; i < cursors.size(); ++i) {
+                takes_part[i] = not cursors[i].done() and cursors[i].type() != SesEdit::Common;
+            }
+
+            auto region = skip_conflict_n(cursors, position);
+
+            for (auto step = skipped_base.size(); step-- > 0;) {
+                auto first   = step * cursors.size();
+                auto deleted = [&](std::size_t i) { return not takes_part[i] or skipped_deletes[first + i]; };
+
+                if (not std::ranges::all_of(std::views::iota(std::size_t{ 0 }, cursors.size()), deleted)) {
+                    break;
+                }
+
+                region.base.begin = skipped_base[step];
+                for (std::size_t i = 0; i < cursors.size(); ++i) {
+                    region.sides[i].begin = skipped_sides[first + i];
                 }
-                ++bc_it;
             }
-        } else if (bc_end()) {
-            while (not ba_end()) {
-                const auto& [ba_elem, ba_info] = *ba_it;
-                if (ba_info.type == SesEdit::Add) {
-                    merged.push_back(ba_elem);
+
+            clear_skipped();
+            result.conflicts.push_back(std::move(region));
+        };
+
+        while (not std::ranges::all_of(cursors, &Cursor::done)) {
+            auto adder      = static_cast<Cursor*>(nullptr);
+            auto add_count  = std::numeric_limits<i64>::max();
+            auto count      = std::numeric_limits<i64>::max();
+            auto any_delete = false;
+
+            for (auto& cursor : cursors) {
+                // a finished cursor is at the end of the base, the others can only add there
+                if (cursor.done()) {
+                    continue;
+                }
+
+                count = std::min(count, cursor.remaining());
+
+                switch (cursor.type()) {
+                case SesEdit::Common: break;
+                case SesEdit::Delete: any_delete = true; break;
+                case SesEdit::Add: {
+                    add_count = std::min(add_count, cursor.remaining());
+                    adder      = adder ? adder : &cursor;
+                } break;
+                }
+            }
+
+            if (adder == nullptr) {
+                if (any_delete) {
+                    skipped_base.push_back(cursors.front().base_index());
+                    for (auto& cursor : cursors) {
+                        skipped_sides.push_back(cursor.side_index());
+                        skipped_deletes.push_back(not cursor.done() and cursor.type() == SesEdit::Delete);
+                    }
+                } else {
+                    auto first = std::ranges::next(base_first, cursors.front().base_index());
+                    result.merged.insert(result.merged.end(), first, std::ranges::next(first, count));
+                    clear_skipped();
+                }
+                advance_all(count);
+                continue;
+            }
+
+            // a lone added run is kept whole, added runs of many ranges only as far as the shortest one goes
+            auto differs = [&](Cursor& cursor) {
+                if (&cursor == adder or cursor.done() or cursor.type() != SesEdit::Add) {
+                    return false;
+                }
+                return not std::equal(adder->added(), adder->added() + add_count, cursor.added(), comp);
+            };
+
+            if (any_delete or std::ranges::any_of(cursors, differs)) {
+                on_conflict();
+                continue;
+            }
+
+            auto added = adder->added();
+            result.merged.insert(result.merged.end(), added, added + add_count);
+            clear_skipped();
+
+            for (auto& cursor : cursors) {
+                if (not cursor.done() and cursor.type() == SesEdit::Add) {
+                    cursor.advance(add_count);
                 }
-                ++ba_it;
             }
         }
 
-        return create_merge<E, Container>(std::move(merged));
+        return result;
+    }
+
+    template <
+        template <typename... EInner> typename Container,
+        Diffable E,
+        template <typename... EInner> typename Cont,
+        typename R1,
+        typename R2,
+        typename R3>
+    Container<E> write_conflict_markers(
+        const MergeRegions<E, Cont>& result,
+        R1&&                         ours,
+        R2&&                         base,
+        R3&&                         theirs,
+        const ConflictMarkers<E>&    markers
+    )
+    {
+        auto written = Container<E>{};
+        auto append  = [&](auto&& range) {
+            written.insert(written.end(), std::ranges::begin(range), std::ranges::end(range));
+        };
+
+        auto done = i64{ 0 };
+
+        for (const auto& region : result.conflicts) {
+            append(IndexRange{ done, region.position }.view(result.merged));
+            done = region.position;
+
+            append(markers.ours);
+            append(region.ours.view(ours));
+            if (not markers.base.empty()) {
+                append(markers.base);
+                append(region.base.view(base));
+            }
+            append(markers.separator);
+            append(region.theirs.view(theirs));
+            append(markers.theirs);
+        }
+
+        append(IndexRange{ done, static_cast<i64>(std::ranges::size(result.merged)) }.view(result.merged));
+
+        return written;
     }
 }
 
@@ -2,38 +2,248 @@
 #define DTLX_DETAIL_PATCH_HPP
 
 #include "dtlx/common.hpp"
+#include "dtlx/constants.hpp"
+#include "dtlx/detail/batch.hpp"
+#include "dtlx/run_ses.hpp"
 #include "dtlx/ses.hpp"
 
-#include <list>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
 
 namespace dtlx::detail
 {
-    template <template <typename... Inner> typename Container, Diffable E, std::ranges::range R>
-        requires std::same_as<RangeElem<R>, E>
-    Container<E> patch(R&& range, const Ses<E>& ses)
+    // the elements of the range are moved out of it when it is an rvalue that owns them
+    template <typename R>
+    constexpr bool can_move_from = not std::is_lvalue_reference_v<R> and not std::ranges::borrowed_range<R>;
+
+    template <bool Move, typename It>
+    auto source(It it)
+    {
+        if constexpr (Move) {
+            return std::make_move_iterator(it);
+        } else {
+            return it;
+        }
+    }
+
+    /**
+     * @brief Patch output that appends to a container.
+     */
+    template <typename Container, bool Move>
+    struct AppendPatch
+    {
+        Container* result;
+
+        template <typename It>
+        It keep(It it, i64 count)
+        {
+            auto next = std::ranges::next(it, count);
+            result->insert(result->end(), source<Move>(it), source<Move>(next));
+            return next;
+        }
+
+        template <typename E>
+        void add(const E* first, i64 count)
+        {
+            result->insert(result->end(), first, first + count);
+        }
+    };
+
+    /**
+     * @brief Patch output that writes to an output iterator.
+     */
+    template <typename Out, bool Move>
+    struct WritePatch
+    {
+        Out out;
+
+        template <typename It>
+        It keep(It it, i64 count)
+        {
+            auto next = std::ranges::next(it, count);
+            out       = std::ranges::copy(source<Move>(it), source<Move>(next), std::move(out)).out;
+            return next;
+        }
+
+        template <typename E>
+        void add(const E* first, i64 count)
+        {
+            out = std::ranges::copy(first, first + count, std::move(out)).out;
+        }
+    };
+
+    /**
+     * @brief Number of elements of a range once patched.
+     */
+    template <std::ranges::sized_range R, typename S>
+    std::size_t patched_size(R&& range, const S& ses)
+    {
+        auto size = static_cast<i64>(std::ranges::size(range)) + ses.add_count() - ses.delete_count();
+        return static_cast<std::size_t>(size);
+    }
+
+    // the edits are applied in one forward pass from `it`: runs of common edits are kept from the range in bulk
+    // and runs of deleted ones are skipped, returns the position in the range after the edits
+    template <Diffable E, typename It, typename Output>
+    It patch_edits(It it, std::span<const SesElem<E>> edits, Output& output)
+    {
+        auto type  = SesEdit::Common;
+        auto count = i64{ 0 };
+
+        auto flush = [&] {
+            if (count == 0) {
+                return;
+            }
+            if (type == SesEdit::Common) {
+                it = output.keep(it, count);
+            } else {
+                std::ranges::advance(it, count);
+            }
+            count = 0;
+        };
+
+        for (const auto& [elem, info] : edits) {
+            if (info.type == SesEdit::Add) {
+                flush();
+                output.add(&elem, 1);
+                continue;
+            }
+            if (info.type != type) {
+                flush();
+                type = info.type;
+            }
+            ++count;
+        }
+
+        flush();
+        return it;
+    }
+
+    // the elements of the range after the end of the SES are kept as they are
+    template <Diffable E, std::ranges::range R, typename Output>
+    void patch_to(R&& range, const Ses<E>& ses, Output& output)
     {
-        // auto result  = Container<E>(std::ranges::begin(range), std::ranges::end(range));    // copies
-        // original u64  res_idx = 0;
+        auto it = patch_edits(std::ranges::begin(range), ses.get(), output);
+        output.keep(it, std::ranges::distance(it, std::ranges::end(range)));
+    }
 
-        auto list    = std::list<E>(std::ranges::begin(range), std::ranges::end(range));
-        auto list_it = list.begin();
+    template <Diffable E, std::ranges::range R, typename Output>
+    void patch_to(R&& range, const RunSes<E>& ses, Output& output)
+    {
+        auto it    = std::ranges::begin(range);
+        auto added = ses.added().data();
 
-        for (const auto& [elem, info] : ses.get()) {
-            switch (info.type) {
+        for (const auto& run : ses.get()) {
+            switch (run.type) {
             case SesEdit::Add: {
-                list.insert(list_it, elem);
-                // ++res_idx;
+                output.add(added, run.length);
+                added += run.length;
             } break;
             case SesEdit::Delete: {
-                list_it = list.erase(list_it);
+                std::ranges::advance(it, run.length);
             } break;
             case SesEdit::Common: {
-                ++list_it;
+                it = output.keep(it, run.length);
             } break;
             }
         }
 
-        return Container<E>(list.begin(), list.end());
+        output.keep(it, std::ranges::distance(it, std::ranges::end(range)));
+    }
+
+    template <template <typename... Inner> typename Container, typename R, typename S>
+    Container<typename S::Elem> patch(R&& range, const S& ses)
+    {
+        auto result = Container<typename S::Elem>{};
+        auto output = AppendPatch<decltype(result), can_move_from<R>>{ &result };
+
+        if constexpr (std::ranges::sized_range<R> and requires { result.reserve(std::size_t{}); }) {
+            result.reserve(patched_size(range, ses));
+        }
+
+        patch_to(range, ses, output);
+        return result;
+    }
+
+    template <typename R, typename S, typename Out>
+    Out patch(R&& range, const S& ses, Out out)
+    {
+        auto output = WritePatch<Out, can_move_from<R>>{ std::move(out) };
+        patch_to(range, ses, output);
+        return std::move(output.out);
+    }
+
+    // whether a SES has enough edits for more than one chunk of a parallel patch
+    template <Diffable E>
+    bool worth_splitting(const Ses<E>& ses, u64 threads)
+    {
+        return threads > 1 and ses.get().size() >= 2 * constants::patch_min_chunk_size;
+    }
+
+    // every edit fixes where its element comes from and where it goes, so the SES is split into chunks whose
+    // offsets in the range and in the output are the prefix sums of the elements the chunks before them read
+    // and write, then the chunks are applied concurrently each into its own part of the output
+    template <typename R, Diffable E, std::random_access_iterator Out>
+    Out patch_parallel(R&& range, const Ses<E>& ses, Out out, u64 threads)
+    {
+        if (not worth_splitting(ses, threads)) {
+            return patch(std::forward<R>(range), ses, std::move(out));
+        }
+
+        auto edits      = ses.get();
+        auto chunk_size = std::max(edits.size() / threads, constants::patch_min_chunk_size);
+        auto chunks     = (edits.size() + chunk_size - 1) / chunk_size;
+
+        auto chunk = [&](std::size_t i) {
+            return edits.subspan(i * chunk_size, std::min(chunk_size, edits.size() - i * chunk_size));
+        };
+
+        // elements of the range read and of the output written by each chunk, then by the chunks before it
+        auto reads  = std::vector<i64>(chunks + 1);
+        auto writes = std::vector<i64>(chunks + 1);
+        auto sizes  = std::vector<u64>(chunks, chunk_size);
+
+        run_batch(sizes, threads, [&](std::size_t i) {
+            auto read  = i64{ 0 };
+            auto write = i64{ 0 };
+
+            for (const auto& [_, info] : chunk(i)) {
+                read  += info.type != SesEdit::Add;
+                write += info.type != SesEdit::Delete;
+            }
+
+            reads[i]  = read;
+            writes[i] = write;
+        });
+
+        std::exclusive_scan(reads.begin(), reads.end(), reads.begin(), i64{ 0 });
+        std::exclusive_scan(writes.begin(), writes.end(), writes.begin(), i64{ 0 });
+
+        using Output = WritePatch<Out, can_move_from<R>>;
+
+        auto source_at = [first = std::ranges::begin(range)](i64 offset) {
+            return first + static_cast<std::ranges::range_difference_t<R>>(offset);
+        };
+        auto output_at = [&](i64 offset) {
+            return Output{ out + static_cast<std::iter_difference_t<Out>>(offset) };
+        };
+
+        run_batch(sizes, threads, [&](std::size_t i) {
+            auto output = output_at(writes[i]);
+            patch_edits(source_at(reads[i]), chunk(i), output);
+        });
+
+        auto output = output_at(writes[chunks]);
+        auto rest   = source_at(reads[chunks]);
+        output.keep(rest, std::ranges::distance(rest, std::ranges::end(range)));
+
+        return std::move(output.out);
     }
 }
 
@@ -0,0 +1,107 @@
+#ifndef DTLX_DETAIL_SNAKE_HPP
+#define DTLX_DETAIL_SNAKE_HPP
+
+#include "dtlx/common.hpp"
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ranges>
+
+// define DTLX_DISABLE_SIMD to always use the portable (word at a time) snake kernel
+#if not defined(DTLX_DISABLE_SIMD)
+#    if defined(__AVX2__)
+#        define DTLX_SIMD_AVX2 1
+#    endif
+#    if defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#        define DTLX_SIMD_SSE2 1
+#    endif
+#endif
+
+#if defined(DTLX_SIMD_AVX2) or defined(DTLX_SIMD_SSE2)
+#    include <immintrin.h>
+#endif
+
+namespace dtlx::detail
+{
+    /**
+     * @brief Ranges and comparison function where the snake can be computed by comparing raw memory.
+     *
+     * Integral elements compare equal if and only if their object representations are equal, so the
+     * diagonal can be walked many elements at a time as long as the comparison is the default one.
+     */
+    template <typename E, typename Comp, typename R1, typename R2>
+    concept BytewiseSnake = requires {
+        requires std::ranges::contiguous_range<R1>;
+        requires std::ranges::contiguous_range<R2>;
+
+        requires std::integral<E>;
+        requires std::has_unique_object_representations_v<E>;
+        requires std::same_as<Comp, std::equal_to<>> or std::same_as<Comp, std::equal_to<E>>;
+    };
+
+    /**
+     * @brief Get the length of the common run at the start of two contiguous sequences.
+     *
+     * @param lhs Pointer to the first sequence.
+     * @param rhs Pointer to the second sequence.
+     * @param size Number of elements to compare at most.
+     *
+     * @return Index of the first mismatching element or `size` if there is none.
+     */
+    template <std::integral T>
+    std::size_t common_run(const T* lhs, const T* rhs, std::size_t size) noexcept
+    {
+        const auto* l     = reinterpret_cast<const unsigned char*>(lhs);
+        const auto* r     = reinterpret_cast<const unsigned char*>(rhs);
+        const auto  bytes = size * sizeof(T);
+
+        auto i = std::size_t{ 0 };
+
+#if defined(DTLX_SIMD_AVX2)
+        for (; i + 32 <= bytes; i += 32) {
+            auto a    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(l + i));
+            auto b    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + i));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+            if (mask != 0xFFFF'FFFF) {
+                return (i + static_cast<std::size_t>(std::countr_one(mask))) / sizeof(T);
+            }
+        }
+#endif
+
+#if defined(DTLX_SIMD_SSE2)
+        for (; i + 16 <= bytes; i += 16) {
+            auto a    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(l + i));
+            auto b    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + i));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+            if (mask != 0xFFFF) {
+                return (i + static_cast<std::size_t>(std::countr_one(mask))) / sizeof(T);
+            }
+        }
+#endif
+
+        if constexpr (std::endian::native == std::endian::little) {
+            for (; i + sizeof(u64) <= bytes; i += sizeof(u64)) {
+                auto a = u64{};
+                auto b = u64{};
+                std::memcpy(&a, l + i, sizeof(u64));
+                std::memcpy(&b, r + i, sizeof(u64));
+                if (a != b) {
+                    return (i + static_cast<std::size_t>(std::countr_zero(a ^ b)) / 8) / sizeof(T);
+                }
+            }
+        }
+
+        for (; i < bytes; ++i) {
+            if (l[i] != r[i]) {
+                return i / sizeof(T);
+            }
+        }
+
+        return size;
+    }
+}
+
+#endif /* end of include guard: DTLX_DETAIL_SNAKE_HPP */
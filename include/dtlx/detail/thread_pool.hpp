@@ -0,0 +1,212 @@
+#ifndef DTLX_DETAIL_THREAD_POOL_HPP
+#define DTLX_DETAIL_THREAD_POOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dtlx::detail
+{
+    /**
+     * @class ThreadPool
+     *
+     * @brief Work-stealing thread pool for fork-join style tasks.
+     *
+     * Each worker owns a queue: it pushes and pops its own tasks at the back (LIFO, good locality for
+     * recursive splitting) and steals from the front of the other queues when its own is empty. A thread
+     * that waits for a task result keeps executing pending tasks in the meantime, so tasks may submit and
+     * wait for other tasks without deadlocking the pool, and sleeps once there is nothing left to take.
+     */
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * @brief Create a pool with `count` worker threads.
+         *
+         * The thread that waits on the pool also executes tasks, so `count` can be zero.
+         */
+        explicit ThreadPool(std::size_t count)
+        {
+            // one queue per worker plus one shared by the threads outside of the pool
+            for (std::size_t i = 0; i < count + 1; ++i) {
+                m_queues.push_back(std::make_unique<Queue>());
+            }
+
+            m_threads.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                m_threads.emplace_back([this, i](std::stop_token stop) { work(stop, i + 1); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            for (auto& thread : m_threads) {
+                thread.request_stop();
+            }
+            {
+                auto lock = std::unique_lock{ m_mutex };
+                m_cv.notify_all();
+            }
+            m_threads.clear();    // joins
+        }
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const noexcept { return m_threads.size(); }
+
+        /**
+         * @brief Schedule a task to the pool.
+         *
+         * @param fn The task.
+         * @return A future to the result of the task, wait on it using `ThreadPool::wait`.
+         */
+        template <typename Fn>
+        std::future<std::invoke_result_t<Fn>> submit(Fn fn)
+        {
+            using Ret = std::invoke_result_t<Fn>;
+
+            auto task   = std::make_shared<std::packaged_task<Ret()>>(std::move(fn));
+            auto future = task->get_future();
+
+            // count first so that a thief never sees a task that is not accounted for yet
+            m_pending.fetch_add(1, std::memory_order_release);
+
+            auto& queue = *m_queues[s_index.pool == this ? s_index.queue : 0];
+            {
+                auto lock = std::unique_lock{ queue.mutex };
+                queue.tasks.emplace_back([this, task] {
+                    (*task)();
+
+                    // wake the threads waiting for a result, the future is ready at this point
+                    auto done = std::unique_lock{ m_mutex };
+                    m_cv.notify_all();
+                });
+            }
+
+            {
+                auto lock = std::unique_lock{ m_mutex };
+                m_cv.notify_one();
+            }
+
+            return future;
+        }
+
+        /**
+         * @brief Wait for a task to finish while executing the other pending tasks.
+         *
+         * Once there is no pending task left, the thread sleeps until a task finishes or another one is
+         * submitted.
+         *
+         * @param future The future returned by `ThreadPool::submit`.
+         * @return The result of the task.
+         */
+        template <typename T>
+        T wait(std::future<T>& future)
+        {
+            using namespace std::chrono_literals;
+
+            auto ready = [&] { return future.wait_for(0s) == std::future_status::ready; };
+
+            while (not ready()) {
+                if (auto task = take(s_index.pool == this ? s_index.queue : 0); task) {
+                    (*task)();
+                    continue;
+                }
+
+                auto lock = std::unique_lock{ m_mutex };
+                m_cv.wait(lock, [&] { return ready() or m_pending.load(std::memory_order_acquire) > 0; });
+            }
+            return future.get();
+        }
+
+    private:
+        struct Queue
+        {
+            std::mutex       mutex;
+            std::deque<Task> tasks;
+        };
+
+        struct Index
+        {
+            const ThreadPool* pool;
+            std::size_t       queue;
+        };
+
+        void work(std::stop_token stop, std::size_t queue)
+        {
+            s_index = { this, queue };
+
+            while (not stop.stop_requested()) {
+                if (auto task = take(queue); task) {
+                    (*task)();
+                    continue;
+                }
+
+                auto lock = std::unique_lock{ m_mutex };
+                m_cv.wait(lock, stop, [&] { return m_pending.load(std::memory_order_acquire) > 0; });
+            }
+        }
+
+        std::optional<Task> take(std::size_t own)
+        {
+            if (m_pending.load(std::memory_order_acquire) == 0) {
+                return std::nullopt;
+            }
+
+            auto pop = [&](Queue& queue, bool back) -> std::optional<Task> {
+                auto lock = std::unique_lock{ queue.mutex };
+                if (queue.tasks.empty()) {
+                    return std::nullopt;
+                }
+
+                auto task = std::optional<Task>{};
+                if (back) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+
+                m_pending.fetch_sub(1, std::memory_order_release);
+                return task;
+            };
+
+            if (auto task = pop(*m_queues[own], true); task) {
+                return task;
+            }
+
+            for (std::size_t i = 1; i < m_queues.size(); ++i) {
+                if (auto task = pop(*m_queues[(own + i) % m_queues.size()], false); task) {
+                    return task;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        static inline thread_local Index s_index = { nullptr, 0 };
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::jthread>           m_threads;
+
+        std::atomic<std::size_t>    m_pending = 0;
+        std::mutex                  m_mutex;
+        std::condition_variable_any m_cv;
+    };
+}
+
+#endif /* end of include guard: DTLX_DETAIL_THREAD_POOL_HPP */
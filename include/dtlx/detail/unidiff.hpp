@@ -7,6 +7,8 @@
 #include "dtlx/ses.hpp"
 
 #include <algorithm>
+#include <memory_resource>
+#include <ranges>
 #include <utility>
 #include <vector>
 
@@ -30,16 +32,18 @@ namespace dtlx::detail
 
     template <Diffable E, std::ranges::range... Srcs>
         requires (std::same_as<RangeElem<Srcs>, SesElem<E>> and ...)
-    void inline extend_ses_vec(std::vector<SesElem<E>>& dest, Srcs&&... srcs)
+    void inline extend_ses_vec(std::pmr::vector<SesElem<E>>& dest, Srcs&&... srcs)
     {
         auto insert = [&dest](auto&& src) { dest.insert(dest.end(), src.begin(), src.end()); };
         (insert(srcs), ...);
     }
 
-    template <Diffable E>
-    UniHunkSeq<E> unidiff(const Ses<E>& ses)
+    // ses_seq is the SES one element at a time, its elements are `SesElem<E>` (or references to them)
+    template <Diffable E, std::ranges::forward_range Seq>
+        requires std::ranges::sized_range<Seq>
+    UniHunkSeq<E> unidiff(const Seq& ses_seq, bool swapped, std::pmr::memory_resource* resource)
     {
-        auto hunks = UniHunkSeq<E>{};
+        auto hunks = UniHunkSeq<E>{ .inner = std::pmr::vector<UniHunk<E>>{ resource } };
 
         i64 l_cnt  = 1;
         i64 middle = 0;
@@ -50,28 +54,33 @@ namespace dtlx::detail
         auto adds    = std::vector<SesElem<E>>{};
         auto deletes = std::vector<SesElem<E>>{};
 
-        const auto ses_seq = ses.get();
-        const i64  length  = ses_seq.size();
+        const auto length = static_cast<i64>(std::ranges::size(ses_seq));
+
+        auto new_hunk = [resource] {
+            return UniHunk<E>{
+                .a             = 0,
+                .b             = 0,
+                .c             = 0,
+                .d             = 0,
+                .common_0      = std::pmr::vector<SesElem<E>>{ resource },
+                .common_1      = std::pmr::vector<SesElem<E>>{ resource },
+                .change        = std::pmr::vector<SesElem<E>>{ resource },
+                .inc_dec_count = 0,
+            };
+        };
 
         // scratch hunk (will be modified and sometimes moved/reset in the for loop below)
-        auto hunk = UniHunk<E>{
-            .a             = 0,
-            .b             = 0,
-            .c             = 0,
-            .d             = 0,
-            .common_0      = {},
-            .common_1      = {},
-            .change        = {},
-            .inc_dec_count = 0,
-        };
+        auto hunk = new_hunk();
+
+        for (auto it = std::ranges::begin(ses_seq); it != std::ranges::end(ses_seq); ++it, ++l_cnt) {
+            decltype(auto) elem = *it;
 
-        for (auto it = ses_seq.begin(); it != ses_seq.end(); ++it, ++l_cnt) {
-            switch (it->info.type) {
+            switch (elem.info.type) {
             case SesEdit::Add: {
                 middle = 0;
                 ++hunk.inc_dec_count;
 
-                adds.push_back(*it);
+                adds.push_back(elem);
 
                 if (not is_middle) {
                     is_middle = true;
@@ -87,7 +96,7 @@ namespace dtlx::detail
                 middle = 0;
                 --hunk.inc_dec_count;
 
-                deletes.push_back(*it);
+                deletes.push_back(elem);
 
                 if (not is_middle) {
                     is_middle = true;
@@ -106,8 +115,8 @@ namespace dtlx::detail
                 if (hunk.common_1.empty() and adds.empty() and deletes.empty() and hunk.change.empty()) {
                     if (hunk.common_0.size() < constants::unidiff_context_size) {
                         if (hunk.a == 0 and hunk.c == 0) {
-                            const auto& info = it->info;
-                            if (not ses.is_swapped()) {
+                            const auto& info = elem.info;
+                            if (not swapped) {
                                 hunk.a = info.index_before;
                                 hunk.c = info.index_after;
                             } else {
@@ -115,11 +124,11 @@ namespace dtlx::detail
                                 hunk.c = info.index_before;
                             }
                         }
-                        hunk.common_0.push_back(*it);
+                        hunk.common_0.push_back(elem);
                     } else {
                         std::ranges::rotate(hunk.common_0, hunk.common_0.begin() + 1);
                         hunk.common_0.pop_back();
-                        hunk.common_0.push_back(*it);
+                        hunk.common_0.push_back(elem);
                         ++hunk.a;
                         ++hunk.c;
                         --hunk.b;
@@ -130,7 +139,7 @@ namespace dtlx::detail
                 if (is_middle and not is_after) {
                     ++middle;
                     extend_ses_vec(hunk.change, deletes, adds);
-                    hunk.change.push_back(*it);
+                    hunk.change.push_back(elem);
 
                     if (static_cast<u64>(middle) >= constants::unidiff_separate_size or l_cnt >= length) {
                         is_after = true;
@@ -150,8 +159,9 @@ namespace dtlx::detail
                 auto cit = it;
                 u64  cnt = 0;
 
-                for (u64 i = 0; i < constants::unidiff_separate_size and (cit != ses_seq.end()); ++i, ++cit) {
-                    if (cit->info.type == SesEdit::Common) {
+                auto end = std::ranges::end(ses_seq);
+                for (u64 i = 0; i < constants::unidiff_separate_size and (cit != end); ++i, ++cit) {
+                    if ((*cit).info.type == SesEdit::Common) {
                         ++cnt;
                     }
                 }
@@ -182,11 +192,11 @@ namespace dtlx::detail
                     ++hunk.c;
                 }
 
-                if (ses.is_swapped()) {
+                if (swapped) {
                     std::swap(hunk.a, hunk.c);
                 }
 
-                hunks.inner.push_back(std::exchange(hunk, {}));
+                hunks.inner.push_back(std::exchange(hunk, new_hunk()));
 
                 is_middle = false;
                 is_after  = false;
@@ -198,6 +208,12 @@ namespace dtlx::detail
 
         return hunks;
     }
+
+    template <Diffable E>
+    UniHunkSeq<E> unidiff(const Ses<E>& ses, std::pmr::memory_resource* resource)
+    {
+        return unidiff<E>(ses.get(), ses.is_swapped(), resource);
+    }
 }
 
 #endif /* end of include guard: DTLX_DETAIL_UNIDIFF_HPP */
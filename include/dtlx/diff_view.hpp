@@ -0,0 +1,277 @@
+#ifndef DTLX_DIFF_VIEW_HPP
+#define DTLX_DIFF_VIEW_HPP
+
+#include "dtlx/common.hpp"
+#include "dtlx/concepts.hpp"
+#include "dtlx/detail/diff.hpp"
+#include "dtlx/run_ses.hpp"
+#include "dtlx/sink.hpp"
+#include "dtlx/workspace.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace dtlx::detail
+{
+    /**
+     * @brief Sink that appends the edits it receives to a vector.
+     */
+    template <typename Value>
+    struct AppendSink;
+
+    template <Diffable E>
+    struct AppendSink<SesElem<E>>
+    {
+        std::vector<SesElem<E>>* values;
+
+        void operator()(const E& elem, const ElemInfo& info) { values->push_back({ elem, info }); }
+    };
+
+    template <>
+    struct AppendSink<EditRun>
+    {
+        std::vector<EditRun>* values;
+
+        void operator()(const EditRun& run) { values->push_back(run); }
+    };
+
+    /**
+     * @brief Recorder that passes the edits of a diff to an `AppendSink<Value>`.
+     */
+    template <typename Value, Diffable E>
+    struct AppendRecorder
+    {
+        using type = SinkRecorder<E, AppendSink<Value>>;
+    };
+
+    template <Diffable E>
+    struct AppendRecorder<EditRun, E>
+    {
+        using type = RunSinkRecorder<AppendSink<EditRun>>;
+    };
+}
+
+namespace dtlx
+{
+    /**
+     * @class DiffView
+     *
+     * @brief Input range over the SES of two ranges that is computed as it is iterated.
+     *
+     * The O(NP) algorithm is run one step at a time: the common prefix first, then one segment of the loop
+     * (see `DiffFlags::limit` and `DiffFlags::cost_limit`), then the common suffix. A step only runs once the
+     * edits of the previous one have all been read, so stopping early skips the rest of the diff. Only the edits
+     * of the current step are kept.
+     *
+     * The loop is only split where the limits split `diff`, so that the SES stays the same: with the default
+     * limit one segment usually spans everything between the common prefix and suffix, and reading the first
+     * edit after the prefix costs as much as the whole diff.
+     *
+     * A view created with `anchored_size` is split like `diff` with `DiffFlags::anchored` instead: at the
+     * elements that occur once on both sides, into segments at least that long.
+     *
+     * The ranges are not copied, they must outlive the view.
+     *
+     * @tparam Value `SesElem` of the range elements, or `EditRun`.
+     */
+    template <typename Value, typename R1, typename R2, typename Comp>
+    class DiffView : public std::ranges::view_interface<DiffView<Value, R1, R2, Comp>>
+    {
+    private:
+        using E        = RangeElem<R1>;
+        using Sink     = detail::AppendSink<Value>;
+        using Recorder = typename detail::AppendRecorder<Value, E>::type;
+
+        using DiffLhs = detail::Diff<E, Comp, R1, R2, false>;
+        using DiffRhs = detail::Diff<E, Comp, R2, R1, true>;
+
+        enum class Step
+        {
+            Head,
+            Segments,
+            Tail,
+            Done,
+        };
+
+        // kept on the heap so that the sink and the iterators can point into it when the view is moved
+        struct State
+        {
+            std::vector<Value> values;
+            std::size_t        position = 0;
+            Sink               sink     = { &values };
+            Recorder           out      = Recorder{ &sink };
+
+            std::variant<std::monostate, DiffLhs, DiffRhs> diff;
+
+            detail::OnpLimits  limits        = {};
+            bool               reserve_first = false;
+            bool               trim_suffix   = false;
+            DiffWorkspace*     workspace     = nullptr;
+            std::optional<u64> anchored_size = std::nullopt;
+            Step               step          = Step::Done;
+
+            bool at_end() const { return position == values.size() and step == Step::Done; }
+
+            // run steps until one of them records at least one edit or the diff is done
+            void fill()
+            {
+                values.clear();
+                position = 0;
+
+                while (values.empty() and step != Step::Done) {
+                    std::visit([this](auto& diff) { run_step(diff); }, diff);
+                }
+            }
+
+            void run_step(std::monostate) { step = Step::Done; }
+
+            template <typename Diff>
+            void run_step(Diff& diff)
+            {
+                switch (step) {
+                case Step::Head: {
+                    record_head(diff);
+                    step = Step::Segments;
+                } break;
+                case Step::Segments: {
+                    auto& ws = workspace ? *workspace : default_workspace();
+                    if (record_next_segment(diff, ws)) {
+                        step = Step::Tail;
+                    }
+                } break;
+                case Step::Tail: {
+                    diff.record_tail(out);
+                    out.flush();
+                    step = Step::Done;
+                } break;
+                case Step::Done: break;
+                }
+            }
+
+            template <typename Diff>
+            void record_head(Diff& diff)
+            {
+                if constexpr (detail::HashGroupable<E, Comp>) {
+                    if (anchored_size) {
+                        diff.record_anchored_head(out, *anchored_size);
+                        return;
+                    }
+                }
+                diff.record_head(out, trim_suffix);
+            }
+
+            // returns whether it was the last segment
+            template <typename Diff>
+            bool record_next_segment(Diff& diff, DiffWorkspace& ws)
+            {
+                if constexpr (detail::HashGroupable<E, Comp>) {
+                    if (anchored_size) {
+                        return diff.record_next_anchored_segment(out, limits, ws);
+                    }
+                }
+                return diff.record_next_segment(out, limits, reserve_first, ws).second;
+            }
+        };
+
+    public:
+        class Iterator
+        {
+        public:
+            using value_type      = Value;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            explicit Iterator(State* state)
+                : m_state{ state }
+            {
+            }
+
+            const Value& operator*() const { return m_state->values[m_state->position]; }
+
+            Iterator& operator++()
+            {
+                if (++m_state->position == m_state->values.size()) {
+                    m_state->fill();
+                }
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return m_state->at_end(); }
+
+        private:
+            State* m_state = nullptr;
+        };
+
+        /**
+         * @brief Create a view that diffs the ranges as it is iterated.
+         *
+         * @param lhs The first range.
+         * @param rhs The second range.
+         * @param comp Comparison function.
+         * @param limits Limits of each segment of the O(NP) loop.
+         * @param reserve_first Whether to reserve the path coordinates up to the limit (see `DiffFlags::huge`).
+         * @param trim_suffix Whether to strip the common suffix before diffing (see `DiffFlags::trim_suffix`).
+         * @param workspace Workspace of the O(NP) loop, the default one of the iterating thread if null.
+         * @param anchored_size Minimum size of the segments between anchors (see `DiffFlags::min_segment_size`),
+         *                      the loop is split by the limits if empty.
+         */
+        DiffView(
+            R1&&              lhs,
+            R2&&              rhs,
+            Comp              comp,
+            detail::OnpLimits limits,
+            bool              reserve_first,
+            bool              trim_suffix,
+            DiffWorkspace*    workspace,
+            std::optional<u64> anchored_size = std::nullopt
+        )
+            : m_state{ std::make_unique<State>() }
+        {
+            if (std::ranges::size(lhs) >= std::ranges::size(rhs)) {
+                m_state->diff.template emplace<DiffRhs>(rhs, lhs, comp);
+            } else {
+                m_state->diff.template emplace<DiffLhs>(lhs, rhs, comp);
+            }
+
+            m_state->limits        = limits;
+            m_state->reserve_first = reserve_first;
+            m_state->trim_suffix   = trim_suffix;
+            m_state->workspace     = workspace;
+            m_state->anchored_size = anchored_size;
+            m_state->step          = Step::Head;
+        }
+
+        /**
+         * @brief Create a view over edits that are already computed.
+         */
+        explicit DiffView(std::vector<Value> values)
+            : m_state{ std::make_unique<State>() }
+        {
+            m_state->values = std::move(values);
+        }
+
+        Iterator begin()
+        {
+            if (m_state->values.empty()) {
+                m_state->fill();
+            }
+            return Iterator{ m_state.get() };
+        }
+
+        std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    private:
+        std::unique_ptr<State> m_state;
+    };
+}
+
+#endif /* end of include guard: DTLX_DIFF_VIEW_HPP */
@@ -4,18 +4,43 @@
 #include "dtlx/common.hpp"
 #include "dtlx/concepts.hpp"
 #include "dtlx/constants.hpp"
+#include "dtlx/detail/batch.hpp"
+#include "dtlx/detail/bit_parallel.hpp"
 #include "dtlx/detail/diff.hpp"
 #include "dtlx/detail/merge.hpp"
 #include "dtlx/detail/patch.hpp"
+#include "dtlx/detail/thread_pool.hpp"
 #include "dtlx/detail/unidiff.hpp"
+#include "dtlx/diff_view.hpp"
+#include "dtlx/index_ses.hpp"
+#include "dtlx/intern.hpp"
+#include "dtlx/run_ses.hpp"
+#include "dtlx/sink.hpp"
+#include "dtlx/workspace.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace dtlx
 {
+    using detail::ConflictMarkers;
+    using detail::ConflictRegion;
     using detail::DiffResult;
+    using detail::IndexDiffResult;
+    using detail::IndexRange;
+    using detail::MergeRegions;
     using detail::MergeResult;
+    using detail::MultiConflictRegion;
+    using detail::RunDiffResult;
     using detail::UniDiffResult;
 
     /**
@@ -31,8 +56,171 @@ namespace dtlx
 
         // controls max coordinates size, it is used to segment diff
         u64 limit = constants::default_limit;
+
+        // controls max cost (rounds of the O(NP) loop, each adds one edit to every diagonal) of a segment, unlike
+        // `limit` the segment is cut on the diagonal that got the furthest, the SES is not minimal if reached
+        u64 cost_limit = constants::no_limit;
+
+        // controls whether to strip the common suffix before diffing (the common prefix is always stripped),
+        // the SES stays minimal but may place commons differently from dtl
+        bool trim_suffix = false;
+
+        // controls which algorithm is used, `huge` and `trim_suffix` only apply to `Onp`, `limit` applies to
+        // every algorithm that runs `Onp` on its sub-problems
+        DiffAlgorithm algorithm = DiffAlgorithm::Onp;
+
+        // controls number of threads used by algorithms that can run in parallel (including the caller), `Onp`
+        // splits the sequences on elements that occur once on both sides to run them in parallel (the SES may
+        // differ from the sequential one), this requires the same elements as `DiffAlgorithm::Patience`
+        u64 threads = 1;
+
+        // controls minimum size (sum of both sides) of a sub-problem for it to be run as its own task
+        u64 min_segment_size = constants::parallel_min_size;
+
+        // controls whether `Onp` splits the sequences on elements that occur once on both sides with any number
+        // of threads, as it does with more than one, so that a lazy diff computes one segment at a time (the SES
+        // may differ from the unsplit one)
+        bool anchored = false;
+
+        // controls where the buffers of the algorithm are kept between calls, `default_workspace()` if null
+        DiffWorkspace* workspace = nullptr;
+
+        // controls where the LCS and SES of the result are allocated, `std::pmr::get_default_resource()` if null
+        std::pmr::memory_resource* resource = nullptr;
     };
 
+    namespace detail
+    {
+        /**
+         * @brief Run the algorithm selected by the flags, recording the result with `make_out(swapped)`.
+         *
+         * @return The recorder and the edit distance.
+         */
+        template <typename R1, typename R2, typename Comp, typename MakeOut>
+        auto run_diff(R1&& lhs, R2&& rhs, Comp comp, const DiffFlags& flags, MakeOut make_out)
+        {
+            using E = RangeElem<R1>;
+
+            auto  limits    = OnpLimits{ .max_coords_size = flags.limit, .max_cost = flags.cost_limit };
+            auto& workspace = flags.workspace ? *flags.workspace : default_workspace();
+
+            auto run = [&](auto&& diff_impl, auto& out) -> i64 {
+                switch (flags.algorithm) {
+                case DiffAlgorithm::Onp: {
+                    if constexpr (HashGroupable<E, Comp>) {
+                        if (flags.threads > 1 or flags.anchored) {
+                            return diff_impl.diff_anchored(
+                                out, limits, flags.threads, flags.min_segment_size, workspace
+                            );
+                        }
+                    }
+                } break;
+                case DiffAlgorithm::Linear: {
+                    return diff_impl.diff_linear(out, flags.threads, flags.min_segment_size);
+                }
+                case DiffAlgorithm::Patience: {
+                    if constexpr (HashGroupable<E, Comp>) {
+                        return diff_impl.diff_patience(out, limits, workspace);
+                    }
+                } break;
+                case DiffAlgorithm::Histogram: {
+                    if constexpr (HashGroupable<E, Comp>) {
+                        return diff_impl.diff_histogram(out, limits, workspace);
+                    }
+                } break;
+                }
+                return diff_impl.record_diff(out, limits, flags.huge, flags.trim_suffix, workspace);
+            };
+
+            auto swapped       = std::ranges::size(lhs) >= std::ranges::size(rhs);
+            auto out           = make_out(swapped);
+            auto edit_distance = swapped ? run(Diff<E, Comp, R2, R1, true>{ rhs, lhs, comp }, out)
+                                         : run(Diff<E, Comp, R1, R2, false>{ lhs, rhs, comp }, out);
+
+            return std::pair{ std::move(out), edit_distance };
+        }
+
+        /**
+         * @brief Create a `DiffView` that runs the O(NP) algorithm lazily, or that holds the whole SES if the
+         * flags select another algorithm or more than one thread.
+         */
+        template <typename Value, typename R1, typename R2, typename Comp>
+        DiffView<Value, R1, R2, Comp> make_diff_view(R1&& lhs, R2&& rhs, Comp comp, const DiffFlags& flags)
+        {
+            if (flags.algorithm == DiffAlgorithm::Onp and flags.threads <= 1) {
+                auto limits = OnpLimits{ .max_coords_size = flags.limit, .max_cost = flags.cost_limit };
+
+                if constexpr (HashGroupable<RangeElem<R1>, Comp>) {
+                    if (flags.anchored) {
+                        return {
+                            std::forward<R1>(lhs), std::forward<R2>(rhs), comp, limits, flags.huge, true,
+                            flags.workspace, flags.min_segment_size,
+                        };
+                    }
+                }
+
+                return {
+                    std::forward<R1>(lhs), std::forward<R2>(rhs), comp, limits, flags.huge, flags.trim_suffix,
+                    flags.workspace,
+                };
+            }
+
+            auto values   = std::vector<Value>{};
+            auto sink     = AppendSink<Value>{ &values };
+            auto make_out = [&sink](bool) {
+                return typename AppendRecorder<Value, RangeElem<R1>>::type{ &sink };
+            };
+
+            auto [out, edit_distance] = run_diff(lhs, rhs, comp, flags, make_out);
+            out.flush();
+
+            return DiffView<Value, R1, R2, Comp>{ std::move(values) };
+        }
+
+        /**
+         * @brief Run `compute(lhs, rhs)` on every pair of the batch, the largest first, and pass its result to
+         * `on_result(index, result)` from the thread that computed it.
+         */
+        template <typename Pairs, typename Compute, typename OnResult>
+        void for_each_pair(Pairs&& pairs, u64 threads, Compute compute, OnResult on_result)
+        {
+            auto first = std::ranges::begin(pairs);
+            auto sizes = std::vector<u64>(std::ranges::size(pairs));
+
+            for (std::size_t i = 0; i < sizes.size(); ++i) {
+                decltype(auto) pair = first[static_cast<std::ranges::range_difference_t<Pairs>>(i)];
+                sizes[i]            = std::ranges::size(std::get<0>(pair)) + std::ranges::size(std::get<1>(pair));
+            }
+
+            run_batch(sizes, threads, [&](std::size_t i) {
+                decltype(auto) pair = first[static_cast<std::ranges::range_difference_t<Pairs>>(i)];
+                on_result(i, compute(std::get<0>(pair), std::get<1>(pair)));
+            });
+        }
+
+        /**
+         * @brief Run `compute(lhs, rhs)` on every pair of the batch and collect the results in input order.
+         */
+        template <typename Pairs, typename Compute>
+        auto collect_pairs(Pairs&& pairs, u64 threads, Compute compute)
+        {
+            using Result = std::invoke_result_t<Compute&, PairFirst<Pairs>, PairSecond<Pairs>>;
+
+            auto results = std::vector<std::optional<Result>>(std::ranges::size(pairs));
+            for_each_pair(pairs, threads, compute, [&](std::size_t i, Result&& result) {
+                results[i].emplace(std::move(result));
+            });
+
+            auto collected = std::vector<Result>{};
+            collected.reserve(results.size());
+            for (auto& result : results) {
+                collected.push_back(std::move(*result));
+            }
+
+            return collected;
+        }
+    }
+
     /**
      * @brief Compute the difference between two ranges (edit distance, LCS, and SES).
      *
@@ -53,15 +241,226 @@ namespace dtlx
     {
         using E = RangeElem<R1>;
 
-        if (std::ranges::size(lhs) >= std::ranges::size(rhs)) {
-            auto diff_impl = detail::Diff<E, Comp, R2, R1, true>{ rhs, lhs, comp };
-            return diff_impl.diff(flags.limit, flags.huge);
+        auto* resource = flags.resource ? flags.resource : std::pmr::get_default_resource();
+        auto  make_out = [resource](bool swapped) {
+            return detail::SesRecorder<E>{ Lcs<E>{ resource }, Ses<E>{ swapped, resource } };
+        };
+
+        auto [out, edit_distance] = detail::run_diff(lhs, rhs, comp, flags, make_out);
+
+        return {
+            .lcs           = std::move(out.lcs),
+            .ses           = std::move(out.ses),
+            .edit_distance = edit_distance,
+        };
+    }
+
+    /**
+     * @brief Compute the difference between two ranges without copying their elements.
+     *
+     * The SES only holds the indices of the edits, `IndexSes::elem` looks the elements up from the ranges,
+     * which must outlive it. The elements do not need to be `Diffable`; if they are not, the algorithm runs on
+     * their positions and `DiffAlgorithm::Patience` and `DiffAlgorithm::Histogram` fall back to `Onp`.
+     *
+     * @tparam R1 Random access and sized range.
+     * @tparam R2 Random access and sized range with the same elements as `R1`.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param comp Comparison function.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return The SES and the edit distance, the same as the ones `diff` produces.
+     */
+    template <typename R1, typename R2, typename Comp = std::equal_to<>>
+        requires RandomAccessRange<R1, R2> and SizedRange<R1, R2>
+             and std::same_as<RangeElem<R1>, RangeElem<R2>> and Comparable<RangeElem<R1>, Comp>
+    IndexDiffResult diff_index(R1&& lhs, R2&& rhs, Comp comp = {}, DiffFlags flags = {})
+    {
+        auto* resource = flags.resource ? flags.resource : std::pmr::get_default_resource();
+        auto  make_out = [resource](bool swapped) {
+            return detail::IndexRecorder{ IndexSes{ swapped, resource } };
+        };
+
+        if constexpr (Diffable<RangeElem<R1>>) {
+            auto [out, edit_distance] = detail::run_diff(lhs, rhs, comp, flags, make_out);
+            return { .ses = std::move(out.ses), .edit_distance = edit_distance };
         } else {
-            auto diff_impl = detail::Diff<E, Comp, R1, R2, false>{ lhs, rhs, comp };
-            return diff_impl.diff(flags.limit, flags.huge);
+            auto lhs_pos = std::views::iota(i64{ 0 }, static_cast<i64>(std::ranges::size(lhs)));
+            auto rhs_pos = std::views::iota(i64{ 0 }, static_cast<i64>(std::ranges::size(rhs)));
+
+            // the algorithm always calls the comparison with the element of lhs first
+            auto comp_pos = [&](i64 l, i64 r) -> bool {
+                return comp(std::ranges::begin(lhs)[l], std::ranges::begin(rhs)[r]);
+            };
+
+            auto [out, edit_distance] = detail::run_diff(lhs_pos, rhs_pos, comp_pos, flags, make_out);
+            return { .ses = std::move(out.ses), .edit_distance = edit_distance };
         }
     }
 
+    /**
+     * @brief Compute the difference between two ranges as runs of edits.
+     *
+     * The SES is the same as the one of `diff` but consecutive edits of the same type are stored as one run,
+     * and only the added elements are copied, so it takes memory proportional to the number of changes.
+     *
+     * @tparam R1 `ComparableRange` type with `Diffable` elements.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param comp Comparison function.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return The SES as runs and the edit distance.
+     */
+    template <typename R1, typename R2, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp>
+    RunDiffResult<RangeElem<R1>> diff_runs(R1&& lhs, R2&& rhs, Comp comp = {}, DiffFlags flags = {})
+    {
+        using E = RangeElem<R1>;
+
+        auto* resource = flags.resource ? flags.resource : std::pmr::get_default_resource();
+        auto  make_out = [resource](bool swapped) {
+            return detail::RunRecorder<E>{ RunSes<E>{ swapped, resource } };
+        };
+
+        auto [out, edit_distance] = detail::run_diff(lhs, rhs, comp, flags, make_out);
+
+        return { .ses = std::move(out.ses), .edit_distance = edit_distance };
+    }
+
+    /**
+     * @brief Compute the difference between two ranges and pass the SES to a sink instead of storing it.
+     *
+     * The sink is called with each element and its `ElemInfo` (`SesSink`) or with each run of edits of the
+     * same type (`EditRunSink`), in order, as soon as the algorithm finds them. Nothing is kept except the edits
+     * of the parts run on other threads (see `DiffFlags::threads`) until the parts before them are done.
+     *
+     * @tparam R1 `ComparableRange` type with `Diffable` elements.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements.
+     * @tparam Sink `SesSink` or `EditRunSink` type.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param sink Receives the edits.
+     * @param comp Comparison function.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return The edit distance.
+     */
+    template <typename R1, typename R2, typename Sink, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp>
+             and (SesSink<std::remove_reference_t<Sink>, RangeElem<R1>>
+                  or EditRunSink<std::remove_reference_t<Sink>>)
+    i64 diff_to(R1&& lhs, R2&& rhs, Sink&& sink, Comp comp = {}, DiffFlags flags = {})
+    {
+        using E = RangeElem<R1>;
+        using S = std::remove_reference_t<Sink>;
+
+        auto make_out = [&sink](bool) {
+            if constexpr (SesSink<S, E>) {
+                return detail::SinkRecorder<E, S>{ &sink };
+            } else {
+                return detail::RunSinkRecorder<S>{ &sink };
+            }
+        };
+
+        auto [out, edit_distance] = detail::run_diff(lhs, rhs, comp, flags, make_out);
+        out.flush();
+
+        return edit_distance;
+    }
+
+    /**
+     * @brief Compute the SES of two ranges lazily, as the returned range is iterated.
+     *
+     * Each step of the O(NP) algorithm (the common prefix, one segment of the loop, the common suffix) only runs
+     * when the edits of the previous one have been read, so a consumer that stops early does not pay for the rest
+     * of the diff. The SES is the same as the one from `diff`, so the loop is only split by `DiffFlags::limit`
+     * and `DiffFlags::cost_limit`: with the default ones everything past the common prefix is usually computed
+     * in one step. Other algorithms and `DiffFlags::threads` greater than 1 compute the whole SES up front.
+     *
+     * @tparam R1 `ComparableRange` type with `Diffable` elements, must outlive the view.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements, must outlive the view.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param comp Comparison function.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return Input range of `SesElem`.
+     */
+    template <typename R1, typename R2, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp> and std::ranges::borrowed_range<R1>
+             and std::ranges::borrowed_range<R2>
+    DiffView<SesElem<RangeElem<R1>>, R1, R2, Comp> diff_view(
+        R1&&      lhs,
+        R2&&      rhs,
+        Comp      comp  = {},
+        DiffFlags flags = {}
+    )
+    {
+        return detail::make_diff_view<SesElem<RangeElem<R1>>>(
+            std::forward<R1>(lhs), std::forward<R2>(rhs), comp, flags
+        );
+    }
+
+    /**
+     * @brief Compute the SES of two ranges lazily as runs of edits of the same type.
+     *
+     * The same as `diff_view`, except that a run is only complete once the edit after it is found, so reading
+     * a run may run the next step.
+     *
+     * @return Input range of `EditRun`, the same as the runs from `diff_runs`.
+     */
+    template <typename R1, typename R2, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp> and std::ranges::borrowed_range<R1>
+             and std::ranges::borrowed_range<R2>
+    DiffView<EditRun, R1, R2, Comp> diff_runs_view(R1&& lhs, R2&& rhs, Comp comp = {}, DiffFlags flags = {})
+    {
+        return detail::make_diff_view<EditRun>(std::forward<R1>(lhs), std::forward<R2>(rhs), comp, flags);
+    }
+
+    /**
+     * @brief Compute the difference between two ranges by comparing the ids of their elements.
+     *
+     * Every element is looked up in the intern table (hashed once) and the diff runs on the ids, which is much
+     * faster than comparing the elements themselves when they are expensive to compare, e.g. lines of a file.
+     * Pass a range returned by `InternTable::intern` to skip the lookup for a range that is diffed many times.
+     *
+     * @tparam R1 Random access and sized range, or `Interned` range, with `Diffable` elements.
+     * @tparam R2 Random access and sized range, or `Interned` range, with `Diffable` elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param table The intern table, its `KeyEqual` is used to compare the elements.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return The result of the diff algorithm, the same as the one from comparing the elements directly.
+     */
+    template <typename R1, typename R2, typename E, typename Hash, typename KeyEqual>
+        requires RandomAccessRange<R1, R2> and SizedRange<R1, R2>
+             and std::same_as<RangeElem<R1>, E> and std::same_as<RangeElem<R2>, E>
+    DiffResult<E> diff(R1&& lhs, R2&& rhs, InternTable<E, Hash, KeyEqual>& table, DiffFlags flags = {})
+    {
+        auto lhs_ids = detail::interned_ids(table, lhs);
+        auto rhs_ids = detail::interned_ids(table, rhs);
+
+        auto* resource = flags.resource ? flags.resource : std::pmr::get_default_resource();
+
+        // the ids are only needed until restored, keep them out of the caller's resource
+        flags.resource = nullptr;
+
+        auto id_result = diff(std::span<const u32>{ lhs_ids }, std::span<const u32>{ rhs_ids }, {}, flags);
+        return detail::restore_interned<E>(std::move(id_result), lhs, rhs, resource);
+    }
+
     /**
      * @brief Compute the edit distance between two ranges.
      *
@@ -72,21 +471,260 @@ namespace dtlx
      * @param lhs The first range.
      * @param rhs The second range.
      * @param comp The comparison function.
+     * @param workspace Where the buffers of the algorithm are kept between calls.
      *
      * @return The edit distance between the two ranges.
+     *
+     * For integral elements compared with the default comparison, if the shorter range is no longer than
+     * `constants::bit_parallel_max_size` the distance is computed with bit-vectors instead.
      */
     template <typename R1, typename R2, typename Comp = std::equal_to<>>
         requires ComparableRanges<R1, R2, Comp>
-    [[nodiscard]] i64 edit_distance(R1&& lhs, R2&& rhs, Comp comp = {})
+    [[nodiscard]] i64 edit_distance(
+        R1&&           lhs,
+        R2&&           rhs,
+        Comp           comp      = {},
+        DiffWorkspace& workspace = default_workspace()
+    )
     {
         using E = RangeElem<R1>;
 
+        if constexpr (detail::BitParallel<E, Comp>) {
+            auto shorter = std::min(std::ranges::size(lhs), std::ranges::size(rhs));
+            if (shorter <= constants::bit_parallel_max_size) {
+                return detail::bit_parallel_indel_distance(lhs, rhs);
+            }
+        }
+
         if (std::ranges::size(lhs) >= std::ranges::size(rhs)) {
             auto diff_impl = detail::Diff<E, Comp, R2, R1, true>{ rhs, lhs, comp };
-            return diff_impl.edit_distance();
+            return diff_impl.edit_distance(workspace);
         } else {
             auto diff_impl = detail::Diff<E, Comp, R1, R2, false>{ lhs, rhs, comp };
-            return diff_impl.edit_distance();
+            return diff_impl.edit_distance(workspace);
+        }
+    }
+
+    /**
+     * @brief Compute the edit distance between two ranges by comparing the ids of their elements.
+     *
+     * @tparam R1 Random access and sized range, or `Interned` range, with `Diffable` elements.
+     * @tparam R2 Random access and sized range, or `Interned` range, with `Diffable` elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param table The intern table, its `KeyEqual` is used to compare the elements.
+     *
+     * @return The edit distance between the two ranges.
+     */
+    template <typename R1, typename R2, typename E, typename Hash, typename KeyEqual>
+        requires RandomAccessRange<R1, R2> and SizedRange<R1, R2>
+             and std::same_as<RangeElem<R1>, E> and std::same_as<RangeElem<R2>, E>
+    [[nodiscard]] i64 edit_distance(R1&& lhs, R2&& rhs, InternTable<E, Hash, KeyEqual>& table)
+    {
+        auto lhs_ids = detail::interned_ids(table, lhs);
+        auto rhs_ids = detail::interned_ids(table, rhs);
+
+        return edit_distance(std::span<const u32>{ lhs_ids }, std::span<const u32>{ rhs_ids });
+    }
+
+    /**
+     * @brief Compute the difference between a prepared range and another range.
+     *
+     * Only the other range is interned (looked up in the table of the prepared one), so the work on the
+     * prepared range is done once for any number of diffs, which may run concurrently.
+     *
+     * @param lhs The first range, prepared.
+     * @param rhs The second range.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return The result of the diff algorithm, the same as the one from comparing the elements directly.
+     */
+    template <typename R1, typename Hash, typename KeyEqual, typename R2>
+        requires RandomAccessRange<R1, R2> and SizedRange<R2>
+             and std::same_as<RangeElem<R1>, RangeElem<R2>>
+    DiffResult<RangeElem<R1>> diff(
+        const PreparedSequence<R1, Hash, KeyEqual>& lhs,
+        R2&&                                        rhs,
+        DiffFlags                                   flags = {}
+    )
+    {
+        auto rhs_ids  = lhs.ids_of(rhs);
+        auto resource = flags.resource ? flags.resource : std::pmr::get_default_resource();
+
+        // the ids are only needed until restored, keep them out of the caller's resource
+        flags.resource = nullptr;
+
+        auto id_result = diff(lhs.ids(), std::span<const u32>{ rhs_ids }, {}, flags);
+        return detail::restore_interned<RangeElem<R1>>(std::move(id_result), lhs.range(), rhs, resource);
+    }
+
+    /**
+     * @brief Compute the difference between a range and a prepared range.
+     *
+     * @see diff(const PreparedSequence&, R2&&, DiffFlags)
+     */
+    template <typename R1, typename R2, typename Hash, typename KeyEqual>
+        requires RandomAccessRange<R1, R2> and SizedRange<R1>
+             and std::same_as<RangeElem<R1>, RangeElem<R2>>
+    DiffResult<RangeElem<R1>> diff(
+        R1&&                                        lhs,
+        const PreparedSequence<R2, Hash, KeyEqual>& rhs,
+        DiffFlags                                   flags = {}
+    )
+    {
+        auto lhs_ids  = rhs.ids_of(lhs);
+        auto resource = flags.resource ? flags.resource : std::pmr::get_default_resource();
+
+        flags.resource = nullptr;
+
+        auto id_result = diff(std::span<const u32>{ lhs_ids }, rhs.ids(), {}, flags);
+        return detail::restore_interned<RangeElem<R1>>(std::move(id_result), lhs, rhs.range(), resource);
+    }
+
+    /**
+     * @brief Compute the edit distance between a prepared range and another range.
+     */
+    template <typename R1, typename Hash, typename KeyEqual, typename R2>
+        requires RandomAccessRange<R1, R2> and SizedRange<R2>
+             and std::same_as<RangeElem<R1>, RangeElem<R2>>
+    [[nodiscard]] i64 edit_distance(const PreparedSequence<R1, Hash, KeyEqual>& lhs, R2&& rhs)
+    {
+        auto rhs_ids = lhs.ids_of(rhs);
+        return edit_distance(lhs.ids(), std::span<const u32>{ rhs_ids });
+    }
+
+    /**
+     * @brief Compute the edit distance between a range and a prepared range.
+     */
+    template <typename R1, typename R2, typename Hash, typename KeyEqual>
+        requires RandomAccessRange<R1, R2> and SizedRange<R1>
+             and std::same_as<RangeElem<R1>, RangeElem<R2>>
+    [[nodiscard]] i64 edit_distance(R1&& lhs, const PreparedSequence<R2, Hash, KeyEqual>& rhs)
+    {
+        auto lhs_ids = rhs.ids_of(lhs);
+        return edit_distance(std::span<const u32>{ lhs_ids }, rhs.ids());
+    }
+
+    /**
+     * @brief Compute the edit distance between two ranges if it is not greater than a bound.
+     *
+     * @tparam R1 `ComparableRange` type with `Diffable` elements.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param max_distance The bound of the edit distance.
+     * @param comp The comparison function.
+     * @param workspace Where the buffers of the algorithm are kept between calls.
+     *
+     * @return The edit distance between the two ranges, or `std::nullopt` if it is greater than `max_distance`.
+     *
+     * The calculation stops as soon as the edit distance is known to exceed the bound, so the time depends on
+     * `max_distance` instead of the actual edit distance. Ranges whose sizes differ by more than `max_distance`
+     * are rejected without comparing any element.
+     */
+    template <typename R1, typename R2, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp>
+    [[nodiscard]] std::optional<i64> edit_distance_within(
+        R1&&           lhs,
+        R2&&           rhs,
+        i64            max_distance,
+        Comp           comp      = {},
+        DiffWorkspace& workspace = default_workspace()
+    )
+    {
+        using E = RangeElem<R1>;
+
+        auto lhs_size = static_cast<i64>(std::ranges::size(lhs));
+        auto rhs_size = static_cast<i64>(std::ranges::size(rhs));
+
+        if (std::abs(lhs_size - rhs_size) > max_distance) {
+            return std::nullopt;
+        }
+
+        if constexpr (detail::BitParallel<E, Comp>) {
+            if (static_cast<u64>(std::min(lhs_size, rhs_size)) <= constants::bit_parallel_max_size) {
+                auto distance = detail::bit_parallel_indel_distance(lhs, rhs);
+                return distance <= max_distance ? std::optional{ distance } : std::nullopt;
+            }
+        }
+
+        if (lhs_size >= rhs_size) {
+            auto diff_impl = detail::Diff<E, Comp, R2, R1, true>{ rhs, lhs, comp };
+            return diff_impl.edit_distance_within(max_distance, workspace);
+        } else {
+            auto diff_impl = detail::Diff<E, Comp, R1, R2, false>{ lhs, rhs, comp };
+            return diff_impl.edit_distance_within(max_distance, workspace);
+        }
+    }
+
+    /**
+     * @brief Compute the edit distance between two ranges if it is not greater than a bound, by comparing the
+     * ids of their elements.
+     *
+     * @tparam R1 Random access and sized range, or `Interned` range, with `Diffable` elements.
+     * @tparam R2 Random access and sized range, or `Interned` range, with `Diffable` elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param max_distance The bound of the edit distance.
+     * @param table The intern table, its `KeyEqual` is used to compare the elements.
+     *
+     * @return The edit distance between the two ranges, or `std::nullopt` if it is greater than `max_distance`.
+     */
+    template <typename R1, typename R2, typename E, typename Hash, typename KeyEqual>
+        requires RandomAccessRange<R1, R2> and SizedRange<R1, R2>
+             and std::same_as<RangeElem<R1>, E> and std::same_as<RangeElem<R2>, E>
+    [[nodiscard]] std::optional<i64> edit_distance_within(
+        R1&&                            lhs,
+        R2&&                            rhs,
+        i64                             max_distance,
+        InternTable<E, Hash, KeyEqual>& table
+    )
+    {
+        auto lhs_size = static_cast<i64>(std::ranges::size(lhs));
+        auto rhs_size = static_cast<i64>(std::ranges::size(rhs));
+
+        if (std::abs(lhs_size - rhs_size) > max_distance) {
+            return std::nullopt;
+        }
+
+        auto lhs_ids = detail::interned_ids(table, lhs);
+        auto rhs_ids = detail::interned_ids(table, rhs);
+
+        return edit_distance_within(std::span<const u32>{ lhs_ids }, std::span<const u32>{ rhs_ids }, max_distance);
+    }
+
+    /**
+     * @brief Compute the Levenshtein distance between two ranges.
+     *
+     * Unlike `edit_distance`, replacing an element with another one counts as a single edit.
+     *
+     * @tparam R1 `ComparableRange` type with `Diffable` elements.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param lhs The first range.
+     * @param rhs The second range.
+     * @param comp The comparison function.
+     *
+     * @return The Levenshtein distance between the two ranges.
+     *
+     * Integral elements compared with the default comparison use bit-vectors, taking O(NM/64) time, other
+     * elements take O(NM) time.
+     */
+    template <typename R1, typename R2, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp>
+    [[nodiscard]] i64 levenshtein_distance(R1&& lhs, R2&& rhs, Comp comp = {})
+    {
+        using E = RangeElem<R1>;
+
+        if constexpr (detail::BitParallel<E, Comp>) {
+            return detail::bit_parallel_levenshtein_distance(lhs, rhs);
+        } else {
+            return detail::levenshtein_distance(lhs, rhs, comp);
         }
     }
 
@@ -94,13 +732,37 @@ namespace dtlx
      * @brief Generate a Unified Format diff from a SES.
      *
      * @param ses The SES to convert.
+     * @param resource The memory resource the hunks are allocated from.
      *
      * @return The Unified Format hunks.
      */
     template <Diffable E>
-    [[nodiscard]] UniHunkSeq<E> ses_to_unidiff(const Ses<E>& ses)
+    [[nodiscard]] UniHunkSeq<E> ses_to_unidiff(
+        const Ses<E>&              ses,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    )
+    {
+        return detail::unidiff<E>(ses, resource);
+    }
+
+    /**
+     * @brief Generate a Unified Format diff from a SES stored as runs.
+     *
+     * @param ses The SES to convert.
+     * @param lhs The first range the SES was computed from.
+     * @param resource The memory resource the hunks are allocated from.
+     *
+     * @return The Unified Format hunks, the same as the ones from the expanded SES.
+     */
+    template <Diffable E, typename R>
+        requires RandomAccessRange<R> and std::same_as<RangeElem<R>, E>
+    [[nodiscard]] UniHunkSeq<E> ses_to_unidiff(
+        const RunSes<E>&           ses,
+        R&&                        lhs,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    )
     {
-        return detail::unidiff<E>(ses);
+        return detail::unidiff<E>(ses.elems(lhs), ses.is_swapped(), resource);
     }
 
     /**
@@ -122,15 +784,198 @@ namespace dtlx
     UniDiffResult<RangeElem<R1>> unidiff(R1&& lhs, R2&& rhs, Comp comp = {}, DiffFlags flags = {})
     {
         auto [lcs, ses, edit_dist] = diff(lhs, rhs, comp, flags);
+        auto* resource             = flags.resource ? flags.resource : std::pmr::get_default_resource();
 
         return {
-            .uni_hunks     = ses_to_unidiff(ses),
+            .uni_hunks     = ses_to_unidiff(ses, resource),
             .lcs           = std::move(lcs),
             .ses           = std::move(ses),
             .edit_distance = edit_dist,
         };
     }
 
+    /**
+     * @brief Compute the difference of every pair of ranges of a batch on many threads.
+     *
+     * The pairs are spread over a thread pool, the largest ones first so that a large pair does not start last
+     * and keep one thread busy after the others are done. Each thread uses its own default workspace, so
+     * `DiffFlags::workspace` is ignored; `comp` and `DiffFlags::resource` are used from many threads at once.
+     *
+     * @tparam Pairs `ComparableRangePairs` type, e.g. `std::vector<std::pair<std::string, std::string>>`.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param pairs The pairs of ranges, `std::get<0>` is the first range and `std::get<1>` the second one.
+     * @param comp Comparison function.
+     * @param flags Controls the behavior of the diff algorithm of each pair.
+     * @param threads Number of threads (including the caller).
+     *
+     * @return The result of each pair, in the order of the pairs.
+     */
+    template <typename Pairs, typename Comp = std::equal_to<>>
+        requires ComparableRangePairs<Pairs, Comp>
+    std::vector<DiffResult<RangeElem<PairFirst<Pairs>>>> diff_batch(
+        Pairs&&   pairs,
+        Comp      comp    = {},
+        DiffFlags flags   = {},
+        u64       threads = std::thread::hardware_concurrency()
+    )
+    {
+        flags.workspace = nullptr;
+
+        return detail::collect_pairs(pairs, threads, [&](auto&& lhs, auto&& rhs) {
+            return diff(lhs, rhs, comp, flags);
+        });
+    }
+
+    /**
+     * @brief Compute the difference of every pair of ranges of a batch on many threads, passing each result to
+     * a callback instead of collecting them.
+     *
+     * The same as `diff_batch`, except that `on_result(index, result)` is called with the index of the pair and
+     * its `DiffResult` as soon as it is computed, from the thread that computed it (so possibly concurrently and
+     * not in the order of the pairs).
+     */
+    template <typename Pairs, typename OnResult, typename Comp = std::equal_to<>>
+        requires ComparableRangePairs<Pairs, Comp>
+             and std::invocable<OnResult&, std::size_t, DiffResult<RangeElem<PairFirst<Pairs>>>&&>
+    void diff_batch_to(
+        Pairs&&   pairs,
+        OnResult  on_result,
+        Comp      comp    = {},
+        DiffFlags flags   = {},
+        u64       threads = std::thread::hardware_concurrency()
+    )
+    {
+        flags.workspace = nullptr;
+
+        auto compute = [&](auto&& lhs, auto&& rhs) { return diff(lhs, rhs, comp, flags); };
+        detail::for_each_pair(pairs, threads, compute, on_result);
+    }
+
+    /**
+     * @brief Compute the edit distance of every pair of ranges of a batch on many threads.
+     *
+     * The pairs are scheduled the same as `diff_batch`, each thread uses its own default workspace.
+     *
+     * @return The edit distance of each pair, in the order of the pairs.
+     */
+    template <typename Pairs, typename Comp = std::equal_to<>>
+        requires ComparableRangePairs<Pairs, Comp>
+    [[nodiscard]] std::vector<i64> edit_distance_batch(
+        Pairs&& pairs,
+        Comp    comp    = {},
+        u64     threads = std::thread::hardware_concurrency()
+    )
+    {
+        return detail::collect_pairs(pairs, threads, [&](auto&& lhs, auto&& rhs) {
+            return edit_distance(lhs, rhs, comp);
+        });
+    }
+
+    /**
+     * @brief Compute the Unified Format diff of every pair of ranges of a batch on many threads.
+     *
+     * The pairs are scheduled the same as `diff_batch`.
+     *
+     * @return The result of each pair, in the order of the pairs.
+     */
+    template <typename Pairs, typename Comp = std::equal_to<>>
+        requires ComparableRangePairs<Pairs, Comp>
+    std::vector<UniDiffResult<RangeElem<PairFirst<Pairs>>>> unidiff_batch(
+        Pairs&&   pairs,
+        Comp      comp    = {},
+        DiffFlags flags   = {},
+        u64       threads = std::thread::hardware_concurrency()
+    )
+    {
+        flags.workspace = nullptr;
+
+        return detail::collect_pairs(pairs, threads, [&](auto&& lhs, auto&& rhs) {
+            return unidiff(lhs, rhs, comp, flags);
+        });
+    }
+
+    namespace detail
+    {
+        // diffs of the base against the two other ranges, run at the same time with more than one thread
+        template <typename R1, typename R2, typename R3, typename Comp>
+        auto merge_diffs(R1&& r1, R2&& r2, R3&& r3, Comp comp, DiffFlags flags)
+        {
+            // each diff runs on one thread, more would split it on anchors and change the SES
+            auto threads  = flags.threads;
+            flags.threads = 1;
+
+            if (threads <= 1) {
+                return std::pair{ diff_runs(r2, r1, comp, flags), diff_runs(r2, r3, comp, flags) };
+            }
+
+            // the other thread uses its own default workspace
+            auto other_flags      = flags;
+            other_flags.workspace = nullptr;
+
+            auto pool    = ThreadPool{ 1 };
+            auto pending = pool.submit([&] { return diff_runs(r2, r1, comp, other_flags); });
+            auto diff_bc = diff_runs(r2, r3, comp, flags);
+
+            return std::pair{ pool.wait(pending), std::move(diff_bc) };
+        }
+
+        // diffs the base against every version with `diff_one(version, flags)` on a batch of `flags.threads`
+        // threads, then merges all of them in one walk over their runs
+        template <
+            typename E,
+            template <typename...> typename Container,
+            typename R,
+            typename Versions,
+            typename Comp,
+            typename DiffOne>
+        MergeRegions<E, Container, MultiConflictRegion> merge_versions(
+            R&&        base,
+            Versions&& versions,
+            Comp       comp,
+            DiffFlags  flags,
+            DiffOne    diff_one
+        )
+        {
+            using Version = std::ranges::range_reference_t<Versions>;
+            using Result  = std::invoke_result_t<DiffOne&, Version, DiffFlags>;
+            using Runs    = std::span<const EditRun>::iterator;
+            using Cursor  = LazyRunCursor<Runs, Runs, std::ranges::iterator_t<Version>>;
+
+            auto first = std::ranges::begin(versions);
+            auto count = std::ranges::size(versions);
+            auto sizes = std::vector<u64>(count);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                sizes[i] = std::ranges::size(base) + std::ranges::size(first[static_cast<std::ptrdiff_t>(i)]);
+            }
+
+            // the threads run the diffs side by side, each on one thread so that its SES is the sequential one,
+            // the ones on other threads use their own default workspace
+            auto threads  = flags.threads;
+            flags.threads = 1;
+            if (threads > 1 and count > 1) {
+                flags.workspace = nullptr;
+            }
+
+            auto diffs = std::vector<std::optional<Result>>(count);
+            run_batch(sizes, threads, [&](std::size_t i) {
+                diffs[i].emplace(diff_one(first[static_cast<std::ptrdiff_t>(i)], flags));
+            });
+
+            auto cursors = std::vector<Cursor>{};
+            cursors.reserve(count);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                auto runs    = diffs[i]->ses.get();
+                auto version = std::ranges::begin(first[static_cast<std::ptrdiff_t>(i)]);
+                cursors.emplace_back(runs.begin(), runs.end(), version);
+            }
+
+            return merge_n<E, Container>(std::span{ cursors }, base, comp);
+        }
+    }
+
     /**
      * @brief Merge three ranges into one.
      *
@@ -143,7 +988,10 @@ namespace dtlx
      * @param r2 The second range.
      * @param r3 The third range.
      * @param comp The comparison function.
-     * @param flags Controls the behavior of the diff algorithm.
+     * @param flags Controls the behavior of the diff algorithm, with `DiffFlags::threads` greater than 1 the
+     *              diffs of the base against the two other ranges run at the same time, each on one thread so
+     *              that the result does not depend on the number of threads (`comp` and `DiffFlags::resource`
+     *              are then used from two threads at once).
      *
      * @return The result of the merge operation.
      */
@@ -164,12 +1012,11 @@ namespace dtlx
     {
         using Elem = RangeElem<R1>;
 
-        auto diff_ba = diff(r2, r1, comp, flags);
-        auto diff_bc = diff(r2, r3, comp, flags);
+        auto [diff_ba, diff_bc] = detail::merge_diffs(r1, r2, r3, comp, flags);
 
         auto maybe_trivial = detail::trivially_mergeable(diff_ba, diff_bc);
         if (not maybe_trivial) {
-            return detail::merge<Elem, Container>(diff_ba, diff_bc, comp);
+            return detail::merge<Elem, Container>(diff_ba, diff_bc, r2, comp);
         }
 
         auto result_from = [](auto&& r) {
@@ -189,10 +1036,204 @@ namespace dtlx
     }
 
     /**
-     * @brief Patch a range given a SES.
+     * @brief Check whether three ranges can be merged without building the merged range.
+     *
+     * The diffs of the base against the two other ranges are computed lazily (see `diff_runs_view`) while they
+     * are walked together, so the check stops at the first conflict without computing the steps of the diffs
+     * after it. The diffs are the ones of `merge`, so the answer is the same; they are split into steps only
+     * where `merge` splits them (see `DiffFlags::limit`, `DiffFlags::cost_limit` and `DiffFlags::anchored`).
+     * `DiffFlags::threads` is ignored, both diffs are walked on the calling thread.
+     *
+     * @tparam R1 `ComparableRange` type with `Diffable` elements.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements.
+     * @tparam R3 `ComparableRange` type with `Diffable` elements.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param r1 The first range.
+     * @param r2 The second range, the base.
+     * @param r3 The third range.
+     * @param comp The comparison function.
+     * @param flags Controls the behavior of the diff algorithm.
+     *
+     * @return Whether `merge` with the same arguments would merge rather than conflict.
+     */
+    template <typename R1, typename R2, typename R3, typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp> and ComparableRanges<R2, R3, Comp>
+    [[nodiscard]] bool can_merge(R1&& r1, R2&& r2, R3&& r3, Comp comp = {}, DiffFlags flags = {})
+    {
+        // the same single threaded diffs as `merge`, more threads would compute them up front
+        flags.threads = 1;
+
+        auto view_ba = diff_runs_view(r2, r1, comp, flags);
+        auto view_bc = diff_runs_view(r2, r3, comp, flags);
+
+        auto ba = detail::LazyRunCursor{ view_ba.begin(), view_ba.end(), std::ranges::begin(r1) };
+        auto bc = detail::LazyRunCursor{ view_bc.begin(), view_bc.end(), std::ranges::begin(r3) };
+
+        auto nothing = [](auto&&...) {};
+        auto stop    = [] { return false; };
+
+        return detail::walk_merge(ba, bc, comp, nothing, nothing, nothing, stop);
+    }
+
+    /**
+     * @brief Merge three ranges into one, keeping going past conflicts.
+     *
+     * Unlike `merge`, a conflict does not end the merge: the parts of the ranges the two sides changed
+     * differently are recorded as conflict regions, everything else is merged in the same pass.
+     *
+     * @tparam Container The container template to use for the merged range.
+     * @tparam R1 `ComparableRange` type with `Diffable` elements.
+     * @tparam R2 `ComparableRange` type with `Diffable` elements.
+     * @tparam R3 `ComparableRange` type with `Diffable` elements.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param r1 The first range (ours).
+     * @param r2 The second range, the base.
+     * @param r3 The third range (theirs).
+     * @param comp The comparison function.
+     * @param flags Controls the behavior of the diff algorithm, see `merge`.
+     *
+     * @return The merged range without the conflict regions, and the conflict regions.
+     */
+    template <
+        template <typename...> typename Container,
+        typename R1,
+        typename R2,
+        typename R3,
+        typename Comp = std::equal_to<>>
+        requires ComparableRanges<R1, R2, Comp> and ComparableRanges<R2, R3, Comp>
+    MergeRegions<RangeElem<R1>, Container> merge_regions(
+        R1&&      r1,
+        R2&&      r2,
+        R3&&      r3,
+        Comp      comp  = {},
+        DiffFlags flags = {}
+    )
+    {
+        using Elem = RangeElem<R1>;
+
+        auto [diff_ba, diff_bc] = detail::merge_diffs(r1, r2, r3, comp, flags);
+        return detail::merge_regions<Elem, Container>(diff_ba, diff_bc, r2, comp);
+    }
+
+    /**
+     * @brief Write the result of `merge_regions` with the sides of each conflict region between markers.
      *
      * @tparam Container The container template to use for the result.
      *
+     * @param result The result of `merge_regions` on the three ranges.
+     * @param r1 The first range (ours).
+     * @param r2 The second range, the base.
+     * @param r3 The third range (theirs).
+     * @param markers The markers written around the sides, the base side is left out if its marker is empty.
+     *
+     * @return The merged range with the conflict regions in place.
+     */
+    template <
+        template <typename...> typename Container,
+        Diffable E,
+        template <typename...> typename Cont,
+        std::ranges::random_access_range R1,
+        std::ranges::random_access_range R2,
+        std::ranges::random_access_range R3>
+        requires std::same_as<RangeElem<R1>, E> and std::same_as<RangeElem<R2>, E>
+             and std::same_as<RangeElem<R3>, E>
+    Container<E> write_conflict_markers(
+        const MergeRegions<E, Cont>& result,
+        R1&&                         r1,
+        R2&&                         r2,
+        R3&&                         r3,
+        const ConflictMarkers<E>&    markers
+    )
+    {
+        return detail::write_conflict_markers<Container>(result, r1, r2, r3, markers);
+    }
+
+    /**
+     * @brief Merge any number of ranges changed from the same base into one.
+     *
+     * The base is diffed against every version, concurrently with `DiffFlags::threads` greater than 1, then the
+     * edit scripts are merged in one walk. The versions merge where they all keep the base, where only one of
+     * them changes it, and where the ones that change it make the same change. Anywhere else is a conflict
+     * region, recorded with the elements of the base and of every version it spans. Without any version the
+     * base is returned as it is.
+     *
+     * @tparam Container The container template to use for the merged range.
+     * @tparam R `ComparableRange` type with `Diffable` elements.
+     * @tparam Versions Random access range of ranges comparable with `R`.
+     * @tparam Comp Comparison function type, should be `Comparable` with the range elements.
+     *
+     * @param base The range the versions were changed from.
+     * @param versions The changed ranges.
+     * @param comp The comparison function.
+     * @param flags Controls the behavior of the diff algorithm, with `DiffFlags::threads` greater than 1 the
+     *              diffs of the versions run side by side, each on one thread so that the result does not depend
+     *              on the number of threads.
+     *
+     * @return The merged range without the conflict regions, and the conflict regions.
+     */
+    template <
+        template <typename...> typename Container,
+        typename R,
+        typename Versions,
+        typename Comp = std::equal_to<>>
+        requires std::ranges::random_access_range<Versions> and std::ranges::sized_range<Versions>
+             and ComparableRanges<R, std::ranges::range_reference_t<Versions>, Comp>
+    MergeRegions<RangeElem<R>, Container, MultiConflictRegion> merge_n(
+        R&&        base,
+        Versions&& versions,
+        Comp       comp  = {},
+        DiffFlags  flags = {}
+    )
+    {
+        auto diff_one = [&](auto&& version, DiffFlags version_flags) {
+            return diff_runs(base, version, comp, version_flags);
+        };
+
+        return detail::merge_versions<RangeElem<R>, Container>(base, versions, comp, flags, diff_one);
+    }
+
+    /**
+     * @brief Merge any number of ranges changed from the same prepared base into one.
+     *
+     * The base is interned once for all the diffs, each version is only looked up in its table, the elements are
+     * compared with the `KeyEqual` of the prepared base.
+     *
+     * @see merge_n(R&&, Versions&&, Comp, DiffFlags)
+     */
+    template <
+        template <typename...> typename Container,
+        typename R,
+        typename Hash,
+        typename KeyEqual,
+        typename Versions>
+        requires std::ranges::random_access_range<Versions> and std::ranges::sized_range<Versions>
+             and RandomAccessRange<std::ranges::range_reference_t<Versions>>
+             and std::same_as<RangeElem<R>, RangeElem<std::ranges::range_reference_t<Versions>>>
+    MergeRegions<RangeElem<R>, Container, MultiConflictRegion> merge_n(
+        const PreparedSequence<R, Hash, KeyEqual>& base,
+        Versions&&                                 versions,
+        DiffFlags                                  flags = {}
+    )
+    {
+        auto diff_one = [&](auto&& version, DiffFlags version_flags) {
+            auto ids = base.ids_of(version);
+            return diff_runs(base.ids(), std::span<const u32>{ ids }, {}, version_flags);
+        };
+
+        auto comp = base.key_eq();
+        return detail::merge_versions<RangeElem<R>, Container>(base.range(), versions, comp, flags, diff_one);
+    }
+
+    /**
+     * @brief Patch a range given a SES.
+     *
+     * The result is built in one pass, reserved up front when the container supports it. The elements kept from
+     * the range are moved out of it if it is an rvalue that owns them.
+     *
+     * @tparam Container The container template to use for the result, must support inserting a range at its end.
+     *
      * @param range The range to patch.
      * @param ses The SES to apply.
      *
@@ -205,6 +1246,100 @@ namespace dtlx
         return detail::patch<Container>(std::forward<R>(range), ses);
     }
 
+    /**
+     * @brief Patch a range given a SES stored as runs.
+     *
+     * @tparam Container The container template to use for the result, must support inserting a range at its end.
+     *
+     * @param range The range to patch.
+     * @param ses The SES to apply.
+     *
+     * @return The patched range in a Container<E>.
+     */
+    template <template <typename... Inner> typename Container, Diffable E, std::ranges::range R>
+        requires std::same_as<RangeElem<R>, E>
+    Container<E> patch(R&& range, const RunSes<E>& ses)
+    {
+        return detail::patch<Container>(std::forward<R>(range), ses);
+    }
+
+    /**
+     * @brief Patch a range given a SES, writing the result to an output iterator.
+     *
+     * @param range The range to patch.
+     * @param ses The SES to apply.
+     * @param out The beginning of the destination, must have room for the patched range if it does not grow it.
+     *
+     * @return The iterator past the last element written.
+     */
+    template <Diffable E, std::ranges::range R, std::output_iterator<const E&> Out>
+        requires std::same_as<RangeElem<R>, E>
+    Out patch(R&& range, const Ses<E>& ses, Out out)
+    {
+        return detail::patch(std::forward<R>(range), ses, std::move(out));
+    }
+
+    /**
+     * @brief Patch a range given a SES on many threads.
+     *
+     * The SES is split into chunks, the offsets of each chunk in the range and in the result are computed with a
+     * prefix sum, then the chunks fill the result (sized up front) concurrently. A SES too short to be worth
+     * splitting (see `constants::patch_min_chunk_size`) is applied on the calling thread.
+     *
+     * @tparam Container The container template to use for the result, must be resizable and random access.
+     *
+     * @param range The range to patch.
+     * @param ses The SES to apply.
+     * @param threads The number of threads, including the calling one.
+     *
+     * @return The patched range in a Container<E>.
+     */
+    template <template <typename... Inner> typename Container, Diffable E, std::ranges::random_access_range R>
+        requires std::same_as<RangeElem<R>, E> and std::ranges::sized_range<R> and std::default_initializable<E>
+    Container<E> patch(R&& range, const Ses<E>& ses, u64 threads)
+    {
+        if (not detail::worth_splitting(ses, threads)) {
+            return detail::patch<Container>(std::forward<R>(range), ses);
+        }
+
+        auto result = Container<E>{};
+        result.resize(detail::patched_size(range, ses));
+
+        detail::patch_parallel(std::forward<R>(range), ses, std::ranges::begin(result), threads);
+        return result;
+    }
+
+    /**
+     * @brief Patch a range given a SES on many threads, writing the result to a random access iterator.
+     *
+     * @param range The range to patch.
+     * @param ses The SES to apply.
+     * @param out The beginning of the destination, must have room for the patched range.
+     * @param threads The number of threads, including the calling one.
+     *
+     * @return The iterator past the last element written.
+     *
+     * @see patch(R&&, const Ses<E>&, u64)
+     */
+    template <Diffable E, std::ranges::random_access_range R, std::random_access_iterator Out>
+        requires std::same_as<RangeElem<R>, E> and std::output_iterator<Out, const E&>
+    Out patch(R&& range, const Ses<E>& ses, Out out, u64 threads)
+    {
+        return detail::patch_parallel(std::forward<R>(range), ses, std::move(out), threads);
+    }
+
+    /**
+     * @brief Patch a range given a SES stored as runs, writing the result to an output iterator.
+     *
+     * @see patch(R&&, const Ses<E>&, Out)
+     */
+    template <Diffable E, std::ranges::range R, std::output_iterator<const E&> Out>
+        requires std::same_as<RangeElem<R>, E>
+    Out patch(R&& range, const RunSes<E>& ses, Out out)
+    {
+        return detail::patch(std::forward<R>(range), ses, std::move(out));
+    }
+
 }
 
 #endif /* end of include guard: DTLX_DTLX_HPP */
@@ -0,0 +1,160 @@
+#ifndef DTLX_INDEX_SES_HPP
+#define DTLX_INDEX_SES_HPP
+
+#include "dtlx/common.hpp"
+#include "dtlx/concepts.hpp"
+#include "dtlx/ses.hpp"
+
+#include <cassert>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace dtlx
+{
+    /**
+     * @brief Shortest Edit Script that refers to the elements by their indices instead of holding them.
+     *
+     * Each edit is only its `ElemInfo`: deleted and common elements are at `index_before` in the first
+     * range, added elements are at `index_after` in the second one (both 1-based). The elements are looked
+     * up from the ranges, which must be kept alive by the caller, only when they are asked for.
+     */
+    class IndexSes
+    {
+    public:
+        /**
+         * @brief Create an empty SES.
+         *
+         * @param swapped Whether the sequences were swapped when computing the SES.
+         * @param resource The memory resource the SES allocates from.
+         */
+        IndexSes(bool swapped, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_sequence{ resource }
+            , m_swapped{ swapped }
+        {
+        }
+
+        bool has_changes() const { return not is_only_copy(); }
+        bool is_swapped() const { return m_swapped; }
+
+        bool is_only_add() const { return m_only_add; }
+        bool is_only_delete() const { return m_only_delete; }
+        bool is_only_copy() const { return m_only_copy; }
+
+        std::optional<SesEdit> is_only_one_operation() const
+        {
+            if (is_only_add()) {
+                return SesEdit::Add;
+            } else if (is_only_delete()) {
+                return SesEdit::Delete;
+            } else if (is_only_copy()) {
+                return SesEdit::Common;
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        /**
+         * @brief Get the view of the sequence.
+         */
+        std::span<const ElemInfo> get() const { return m_sequence; }
+
+        /**
+         * @brief Get the element an edit refers to.
+         *
+         * @param info The edit, from this SES.
+         * @param lhs The first range the SES was computed from.
+         * @param rhs The second range the SES was computed from.
+         *
+         * @return Reference to the element in `lhs` for deleted and common elements, in `rhs` for added ones.
+         */
+        template <typename R1, typename R2>
+            requires RandomAccessRange<R1, R2>
+        static auto elem(const ElemInfo& info, R1&& lhs, R2&& rhs)
+            -> std::common_reference_t<std::ranges::range_reference_t<R1>, std::ranges::range_reference_t<R2>>
+        {
+            if (info.type == SesEdit::Add) {
+                return std::ranges::begin(rhs)[info.index_after - 1];
+            } else {
+                return std::ranges::begin(lhs)[info.index_before - 1];
+            }
+        }
+
+        /**
+         * @brief Copy the elements the SES refers to into a `Ses`.
+         *
+         * @param lhs The first range the SES was computed from.
+         * @param rhs The second range the SES was computed from.
+         * @param resource The memory resource the new SES allocates from.
+         */
+        template <typename R1, typename R2>
+            requires RandomAccessRange<R1, R2> and std::same_as<RangeElem<R1>, RangeElem<R2>>
+                 and Diffable<RangeElem<R1>>
+        Ses<RangeElem<R1>> to_ses(
+            R1&&                       lhs,
+            R2&&                       rhs,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+        ) const
+        {
+            auto ses = Ses<RangeElem<R1>>{ m_swapped, resource };
+            for (const auto& info : m_sequence) {
+                ses.add(elem(info, lhs, rhs), info.index_before, info.index_after, info.type);
+            }
+            return ses;
+        }
+
+        /**
+         * @brief Add a new edit to the sequence.
+         */
+        void add(i64 index_before, i64 index_after, SesEdit type)
+        {
+            m_sequence.push_back({ .index_before = index_before, .index_after = index_after, .type = type });
+
+            switch (type) {
+            case SesEdit::Delete: {
+                m_only_copy = false;
+                m_only_add  = false;
+            } break;
+            case SesEdit::Common: {
+                m_only_add    = false;
+                m_only_delete = false;
+            } break;
+            case SesEdit::Add: {
+                m_only_delete = false;
+                m_only_copy   = false;
+            } break;
+            }
+        }
+
+        /**
+         * @brief Append another sequence to the end of this sequence.
+         */
+        void append(IndexSes&& other)
+        {
+            assert(m_swapped == other.m_swapped);
+
+            m_sequence.insert(m_sequence.end(), other.m_sequence.begin(), other.m_sequence.end());
+
+            m_only_add    = m_only_add and other.m_only_add;
+            m_only_delete = m_only_delete and other.m_only_delete;
+            m_only_copy   = m_only_copy and other.m_only_copy;
+        }
+
+        bool operator==(const IndexSes&) const = default;
+
+    private:
+        std::pmr::vector<ElemInfo> m_sequence;
+
+        bool m_only_add    = true;
+        bool m_only_delete = true;
+        bool m_only_copy   = true;
+
+        bool m_swapped = false;
+    };
+}
+
+#endif /* end of include guard: DTLX_INDEX_SES_HPP */
@@ -0,0 +1,268 @@
+#ifndef DTLX_INTERN_HPP
+#define DTLX_INTERN_HPP
+
+#include "dtlx/common.hpp"
+#include "dtlx/concepts.hpp"
+#include "dtlx/detail/diff.hpp"
+
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dtlx
+{
+    /**
+     * @brief Constraint for types that can be interned with `Hash` and `KeyEqual`.
+     */
+    template <typename Elem, typename Hash, typename KeyEqual>
+    concept Internable = requires (const Elem e, Hash hash, KeyEqual eq) {
+        requires Diffable<Elem>;
+        { hash(e) } -> std::convertible_to<std::size_t>;
+        { eq(e, e) } -> std::same_as<bool>;
+    };
+
+    /**
+     * @class Interned
+     *
+     * @brief A range together with the ids of its elements in an `InternTable`.
+     *
+     * Behaves like the underlying range so it can be passed anywhere a range is expected; the diff functions
+     * that take an `InternTable` use the ids directly instead of interning the range again.
+     */
+    template <std::ranges::view R>
+    class Interned
+    {
+    public:
+        Interned(R range, std::vector<u32> ids)
+            : m_range{ std::move(range) }
+            , m_ids{ std::move(ids) }
+        {
+            assert(std::ranges::size(m_range) == m_ids.size());
+        }
+
+        auto begin() const { return std::ranges::begin(m_range); }
+        auto end() const { return std::ranges::end(m_range); }
+        auto size() const { return std::ranges::size(m_range); }
+
+        const R&             range() const noexcept { return m_range; }
+        std::span<const u32> ids() const noexcept { return m_ids; }
+
+    private:
+        R                m_range;
+        std::vector<u32> m_ids;
+    };
+
+    template <typename R>
+    inline constexpr bool is_interned_v = false;
+
+    template <typename R>
+    inline constexpr bool is_interned_v<Interned<R>> = true;
+
+    /**
+     * @class InternTable
+     *
+     * @brief Maps each distinct element to a dense integer id.
+     *
+     * Elements that are equal according to `KeyEqual` get the same id, so diffing the ids gives the same
+     * result as diffing the elements while each comparison is a single integer compare. The table can be
+     * reused for many diffs; the ids stay stable until `clear` is called.
+     */
+    template <typename E, typename Hash = std::hash<E>, typename KeyEqual = std::equal_to<E>>
+        requires Internable<E, Hash, KeyEqual>
+    class InternTable
+    {
+    public:
+        using Elem = E;
+
+        InternTable(Hash hash = {}, KeyEqual eq = {})
+            : m_ids{ 0, std::move(hash), std::move(eq) }
+        {
+        }
+
+        /**
+         * @brief Get the id of an element, assigning a new one if it is not in the table yet.
+         */
+        u32 intern(const Elem& elem)
+        {
+            assert(m_ids.size() < std::numeric_limits<u32>::max());
+
+            auto [it, _] = m_ids.try_emplace(elem, static_cast<u32>(m_ids.size()));
+            return it->second;
+        }
+
+        /**
+         * @brief Intern all elements of a range.
+         *
+         * @param range The range, must outlive the result if it is an lvalue.
+         * @return The range together with the ids of its elements.
+         */
+        template <std::ranges::viewable_range R>
+            requires std::same_as<RangeElem<R>, Elem> and SizedRange<R>
+        Interned<std::views::all_t<R>> intern(R&& range)
+        {
+            auto ids = std::vector<u32>{};
+            ids.reserve(std::ranges::size(range));
+
+            for (const auto& elem : range) {
+                ids.push_back(intern(elem));
+            }
+
+            return { std::views::all(std::forward<R>(range)), std::move(ids) };
+        }
+
+        std::size_t size() const noexcept { return m_ids.size(); }
+        void        clear() noexcept { m_ids.clear(); }
+
+    private:
+        std::unordered_map<Elem, u32, Hash, KeyEqual> m_ids;
+    };
+
+    /**
+     * @class PreparedSequence
+     *
+     * @brief A range interned once to be diffed against many other ranges.
+     *
+     * The elements of the other range are only looked up in the table of the prepared one: an element that is
+     * not in it can not be common, so they all get `unmatched_id` instead of a new id. Nothing is modified after
+     * the sequence is prepared, so it can be diffed from many threads at once.
+     */
+    template <
+        std::ranges::view R,
+        typename Hash     = std::hash<RangeElem<R>>,
+        typename KeyEqual = std::equal_to<RangeElem<R>>>
+        requires Internable<RangeElem<R>, Hash, KeyEqual> and SizedRange<R>
+    class PreparedSequence
+    {
+    public:
+        using Elem = RangeElem<R>;
+
+        static constexpr u32 unmatched_id = std::numeric_limits<u32>::max();
+
+        /**
+         * @brief Intern the elements of a range.
+         *
+         * @param range The range, must outlive the prepared sequence if it is not owned by the view.
+         */
+        explicit PreparedSequence(R range, Hash hash = {}, KeyEqual eq = {})
+            : m_range{ std::move(range) }
+            , m_table{ 0, std::move(hash), std::move(eq) }
+        {
+            m_ids.reserve(std::ranges::size(m_range));
+
+            for (const auto& elem : m_range) {
+                assert(m_table.size() < unmatched_id);
+
+                auto [it, _] = m_table.try_emplace(elem, static_cast<u32>(m_table.size()));
+                m_ids.push_back(it->second);
+            }
+        }
+
+        const R&             range() const noexcept { return m_range; }
+        std::span<const u32> ids() const noexcept { return m_ids; }
+        KeyEqual             key_eq() const { return m_table.key_eq(); }
+
+        /**
+         * @brief Get the ids of the elements of another range in the table of this one.
+         */
+        template <typename R2>
+            requires std::same_as<RangeElem<R2>, Elem> and SizedRange<R2>
+        std::vector<u32> ids_of(const R2& other) const
+        {
+            auto ids = std::vector<u32>{};
+            ids.reserve(std::ranges::size(other));
+
+            for (const auto& elem : other) {
+                auto it = m_table.find(elem);
+                ids.push_back(it == m_table.end() ? unmatched_id : it->second);
+            }
+
+            return ids;
+        }
+
+    private:
+        R                                             m_range;
+        std::vector<u32>                              m_ids;
+        std::unordered_map<Elem, u32, Hash, KeyEqual> m_table;
+    };
+
+    template <std::ranges::viewable_range R>
+    PreparedSequence(R&&) -> PreparedSequence<std::views::all_t<R>>;
+
+    template <std::ranges::viewable_range R, typename Hash>
+    PreparedSequence(R&&, Hash) -> PreparedSequence<std::views::all_t<R>, Hash>;
+
+    template <std::ranges::viewable_range R, typename Hash, typename KeyEqual>
+    PreparedSequence(R&&, Hash, KeyEqual) -> PreparedSequence<std::views::all_t<R>, Hash, KeyEqual>;
+}
+
+namespace dtlx::detail
+{
+    /**
+     * @brief Get the ids of a range, interning it first if it is not `Interned` already.
+     */
+    template <typename Table, typename R>
+    auto interned_ids(Table& table, const R& range)
+    {
+        if constexpr (is_interned_v<R>) {
+            return range.ids();
+        } else {
+            auto ids = std::vector<u32>{};
+            ids.reserve(std::ranges::size(range));
+
+            for (const auto& elem : range) {
+                ids.push_back(table.intern(elem));
+            }
+            return ids;
+        }
+    }
+
+    /**
+     * @brief Rebuild the result of a diff on ids with the original elements.
+     *
+     * The indices of the SES always refer to `lhs` and `rhs`, so the elements can be picked back from them.
+     */
+    template <Diffable E, typename R1, typename R2>
+    DiffResult<E> restore_interned(
+        DiffResult<u32>&&          id_result,
+        const R1&                  lhs,
+        const R2&                  rhs,
+        std::pmr::memory_resource* resource
+    )
+    {
+        auto at = [](const auto& range, i64 index) -> E {
+            return std::ranges::begin(range)[index - 1];
+        };
+
+        auto lcs = Lcs<E>{ resource };
+        auto ses = Ses<E>{ id_result.ses.is_swapped(), resource };
+
+        for (const auto& [_, info] : id_result.ses.get()) {
+            switch (info.type) {
+            case SesEdit::Delete: {
+                ses.add(at(lhs, info.index_before), info.index_before, info.index_after, info.type);
+            } break;
+            case SesEdit::Add: {
+                ses.add(at(rhs, info.index_after), info.index_before, info.index_after, info.type);
+            } break;
+            case SesEdit::Common: {
+                lcs.add(at(lhs, info.index_before));
+                ses.add(at(lhs, info.index_before), info.index_before, info.index_after, info.type);
+            } break;
+            }
+        }
+
+        return {
+            .lcs           = std::move(lcs),
+            .ses           = std::move(ses),
+            .edit_distance = id_result.edit_distance,
+        };
+    }
+}
+
+#endif /* end of include guard: DTLX_INTERN_HPP */
@@ -3,6 +3,8 @@
 
 #include "dtlx/concepts.hpp"
 
+#include <iterator>
+#include <memory_resource>
 #include <span>
 #include <vector>
 
@@ -19,6 +21,14 @@ namespace dtlx
 
         Lcs() = default;
 
+        /**
+         * @brief Create an empty sequence that allocates from `resource`.
+         */
+        explicit Lcs(std::pmr::memory_resource* resource)
+            : m_sequence{ resource }
+        {
+        }
+
         /**
          * @brief Get the view of the sequence.
          */
@@ -33,12 +43,24 @@ namespace dtlx
             m_sequence.emplace_back(std::forward<Args>(args)...);
         }
 
+        /**
+         * @brief Append another sequence to the end of this sequence.
+         */
+        void append(Lcs&& other)
+        {
+            m_sequence.insert(
+                m_sequence.end(),
+                std::make_move_iterator(other.m_sequence.begin()),
+                std::make_move_iterator(other.m_sequence.end())
+            );
+        }
+
         bool operator==(const Lcs&) const
             requires TriviallyComparable<Elem>
         = default;
 
     private:
-        std::vector<Elem> m_sequence;
+        std::pmr::vector<Elem> m_sequence;
     };
 };
 
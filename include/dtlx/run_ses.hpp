@@ -0,0 +1,308 @@
+#ifndef DTLX_RUN_SES_HPP
+#define DTLX_RUN_SES_HPP
+
+#include "dtlx/common.hpp"
+#include "dtlx/concepts.hpp"
+#include "dtlx/ses.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace dtlx
+{
+    /**
+     * @struct EditRun
+     *
+     * @brief Consecutive edits of the same type.
+     *
+     * The indices are those of the first edit of the run and follow `ElemInfo`: 1-based, 0 on the side the
+     * elements are missing from.
+     */
+    struct EditRun
+    {
+        i64     index_before;
+        i64     index_after;
+        i64     length;
+        SesEdit type;
+
+        /**
+         * @brief Get the info of the edit at `offset` in the run.
+         */
+        ElemInfo info(i64 offset) const noexcept
+        {
+            assert(offset >= 0 and offset < length);
+
+            return {
+                .index_before = index_before == 0 ? 0 : index_before + offset,
+                .index_after  = index_after == 0 ? 0 : index_after + offset,
+                .type         = type,
+            };
+        }
+
+        /**
+         * @brief Whether `next` continues this run, i.e. both can be stored as one run.
+         */
+        bool is_continued_by(const EditRun& next) const noexcept
+        {
+            auto continues = [this](i64 index, i64 next_index) {
+                return index == 0 ? next_index == 0 : next_index == index + length;
+            };
+            return next.type == type and continues(index_before, next.index_before)
+               and continues(index_after, next.index_after);
+        }
+
+        bool operator==(const EditRun&) const = default;
+    };
+}
+
+namespace dtlx::detail
+{
+    /**
+     * @brief Iterator over the edits of a `RunSes` one element at a time.
+     *
+     * Added elements come from the SES, deleted and common ones from the first range.
+     */
+    template <Diffable E, std::random_access_iterator It>
+    class RunSesIterator
+    {
+    public:
+        using value_type      = SesElem<E>;
+        using difference_type = std::ptrdiff_t;
+
+        RunSesIterator() = default;
+
+        RunSesIterator(const EditRun* run, const E* added, It lhs)
+            : m_run{ run }
+            , m_added{ added }
+            , m_lhs{ lhs }
+        {
+        }
+
+        SesElem<E> operator*() const
+        {
+            auto info = m_run->info(m_offset);
+            if (info.type == SesEdit::Add) {
+                return { *m_added, info };
+            }
+            return { m_lhs[static_cast<std::iter_difference_t<It>>(info.index_before - 1)], info };
+        }
+
+        RunSesIterator& operator++()
+        {
+            if (m_run->type == SesEdit::Add) {
+                ++m_added;
+            }
+            if (++m_offset == m_run->length) {
+                ++m_run;
+                m_offset = 0;
+            }
+            return *this;
+        }
+
+        RunSesIterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const RunSesIterator& other) const
+        {
+            return m_run == other.m_run and m_offset == other.m_offset;
+        }
+
+    private:
+        const EditRun* m_run    = nullptr;
+        i64            m_offset = 0;
+        const E*       m_added  = nullptr;
+        It             m_lhs    = {};
+    };
+}
+
+namespace dtlx
+{
+    /**
+     * @brief Shortest Edit Script stored as runs of edits of the same type.
+     *
+     * Only the added elements are kept, the deleted and common ones are looked up from the first range when
+     * needed, so the size of the SES depends on the number of changes instead of the size of the sequences.
+     */
+    template <Diffable E>
+    class RunSes
+    {
+    public:
+        using Elem = E;
+
+        /**
+         * @brief Create an empty SES.
+         *
+         * @param swapped Whether the sequences were swapped when computing the SES.
+         * @param resource The memory resource the SES allocates from.
+         */
+        RunSes(bool swapped, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_runs{ resource }
+            , m_added{ resource }
+            , m_swapped{ swapped }
+        {
+        }
+
+        bool has_changes() const { return not is_only_copy(); }
+        bool is_swapped() const { return m_swapped; }
+
+        bool is_only_add() const { return only(SesEdit::Add); }
+        bool is_only_delete() const { return only(SesEdit::Delete); }
+        bool is_only_copy() const { return only(SesEdit::Common); }
+
+        std::optional<SesEdit> is_only_one_operation() const
+        {
+            if (is_only_add()) {
+                return SesEdit::Add;
+            } else if (is_only_delete()) {
+                return SesEdit::Delete;
+            } else if (is_only_copy()) {
+                return SesEdit::Common;
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        /**
+         * @brief Get the view of the runs.
+         */
+        std::span<const EditRun> get() const { return m_runs; }
+
+        /**
+         * @brief Get the added elements, in the order of the runs.
+         */
+        std::span<const Elem> added() const { return m_added; }
+
+        /**
+         * @brief Number of edits, one per element.
+         */
+        i64 size() const { return m_size; }
+
+        /**
+         * @brief Number of added and of deleted elements.
+         */
+        i64 add_count() const { return static_cast<i64>(m_added.size()); }
+        i64 delete_count() const { return m_delete_count; }
+
+        /**
+         * @brief Get the edits one element at a time, the same as the ones of `Ses::get`.
+         *
+         * @param lhs The first range the SES was computed from.
+         */
+        template <typename R>
+            requires RandomAccessRange<R> and std::same_as<RangeElem<R>, E>
+        auto elems(R&& lhs) const
+        {
+            using Iter = detail::RunSesIterator<E, std::ranges::iterator_t<const std::remove_cvref_t<R>>>;
+
+            auto first = std::ranges::cbegin(lhs);
+            auto begin = Iter{ m_runs.data(), m_added.data(), first };
+            auto end   = Iter{ m_runs.data() + m_runs.size(), m_added.data() + m_added.size(), first };
+
+            return std::ranges::subrange{ begin, end, static_cast<std::size_t>(m_size) };
+        }
+
+        /**
+         * @brief Expand the runs into a `Ses`.
+         *
+         * @param lhs The first range the SES was computed from.
+         * @param resource The memory resource the new SES allocates from.
+         */
+        template <typename R>
+            requires RandomAccessRange<R> and std::same_as<RangeElem<R>, E>
+        Ses<E> to_ses(R&& lhs, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+        {
+            auto ses = Ses<E>{ m_swapped, resource };
+            for (const auto& [elem, info] : elems(lhs)) {
+                ses.add(elem, info.index_before, info.index_after, info.type);
+            }
+            return ses;
+        }
+
+        /**
+         * @brief Add a new edit, extending the last run if it continues it.
+         */
+        void add(const Elem& elem, i64 index_before, i64 index_after, SesEdit type)
+        {
+            if (type == SesEdit::Add) {
+                m_added.push_back(elem);
+            }
+            add_run(index_before, index_after, 1, type);
+        }
+
+        /**
+         * @brief Add `length` common elements.
+         */
+        void add_common(i64 index_before, i64 index_after, i64 length)
+        {
+            if (length > 0) {
+                add_run(index_before, index_after, length, SesEdit::Common);
+            }
+        }
+
+        /**
+         * @brief Append another sequence to the end of this sequence.
+         */
+        void append(RunSes&& other)
+        {
+            assert(m_swapped == other.m_swapped);
+
+            for (const auto& run : other.m_runs) {
+                add_run(run.index_before, run.index_after, run.length, run.type);
+            }
+            m_added.insert(
+                m_added.end(),
+                std::make_move_iterator(other.m_added.begin()),
+                std::make_move_iterator(other.m_added.end())
+            );
+        }
+
+        bool operator==(const RunSes&) const
+            requires TriviallyComparable<Elem>
+        = default;
+
+    private:
+        bool only(SesEdit type) const
+        {
+            return std::ranges::all_of(m_runs, [type](const EditRun& run) { return run.type == type; });
+        }
+
+        void add_run(i64 index_before, i64 index_after, i64 length, SesEdit type)
+        {
+            m_size         += length;
+            m_delete_count += type == SesEdit::Delete ? length : 0;
+
+            auto run = EditRun{
+                .index_before = index_before,
+                .index_after  = index_after,
+                .length       = length,
+                .type         = type,
+            };
+
+            if (not m_runs.empty() and m_runs.back().is_continued_by(run)) {
+                m_runs.back().length += length;
+            } else {
+                m_runs.push_back(run);
+            }
+        }
+
+        std::pmr::vector<EditRun> m_runs;
+        std::pmr::vector<Elem>    m_added;
+        i64                       m_size         = 0;
+        i64                       m_delete_count = 0;
+        bool                      m_swapped      = false;
+    };
+}
+
+#endif /* end of include guard: DTLX_RUN_SES_HPP */
@@ -4,7 +4,11 @@
 #include "dtlx/common.hpp"
 #include "dtlx/concepts.hpp"
 
+#include <iterator>
+#include <memory_resource>
+#include <optional>
 #include <span>
+#include <vector>
 
 namespace dtlx
 {
@@ -17,8 +21,15 @@ namespace dtlx
     public:
         using Elem = E;
 
-        Ses(bool swapped)
-            : m_swapped{ swapped }
+        /**
+         * @brief Create an empty SES.
+         *
+         * @param swapped Whether the sequences were swapped when computing the SES.
+         * @param resource The memory resource the SES allocates from.
+         */
+        Ses(bool swapped, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_sequence{ resource }
+            , m_swapped{ swapped }
         {
         }
 
@@ -47,6 +58,12 @@ namespace dtlx
          */
         std::span<const SesElem<Elem>> get() const { return m_sequence; }
 
+        /**
+         * @brief Number of added and of deleted elements.
+         */
+        i64 add_count() const { return m_add_count; }
+        i64 delete_count() const { return m_delete_count; }
+
         /**
          * @brief Add a new element to the sequence.
          */
@@ -64,6 +81,7 @@ namespace dtlx
             case SesEdit::Delete: {
                 m_only_copy = false;
                 m_only_add  = false;
+                ++m_delete_count;
             } break;
             case SesEdit::Common: {
                 m_only_add    = false;
@@ -72,21 +90,46 @@ namespace dtlx
             case SesEdit::Add: {
                 m_only_delete = false;
                 m_only_copy   = false;
+                ++m_add_count;
             } break;
             }
         }
 
+        /**
+         * @brief Append another sequence to the end of this sequence.
+         */
+        void append(Ses&& other)
+        {
+            assert(m_swapped == other.m_swapped);
+
+            m_sequence.insert(
+                m_sequence.end(),
+                std::make_move_iterator(other.m_sequence.begin()),
+                std::make_move_iterator(other.m_sequence.end())
+            );
+
+            m_only_add    = m_only_add and other.m_only_add;
+            m_only_delete = m_only_delete and other.m_only_delete;
+            m_only_copy   = m_only_copy and other.m_only_copy;
+
+            m_add_count    += other.m_add_count;
+            m_delete_count += other.m_delete_count;
+        }
+
         bool operator==(const Ses&) const
             requires TriviallyComparable<Elem>
         = default;
 
     private:
-        std::vector<SesElem<Elem>> m_sequence;
+        std::pmr::vector<SesElem<Elem>> m_sequence;
 
         bool m_only_add    = true;
         bool m_only_delete = true;
         bool m_only_copy   = true;
 
+        i64 m_add_count    = 0;
+        i64 m_delete_count = 0;
+
         bool m_swapped = false;
     };
 }
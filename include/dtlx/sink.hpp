@@ -0,0 +1,166 @@
+#ifndef DTLX_SINK_HPP
+#define DTLX_SINK_HPP
+
+#include "dtlx/common.hpp"
+#include "dtlx/concepts.hpp"
+#include "dtlx/run_ses.hpp"
+
+#include <concepts>
+#include <optional>
+#include <vector>
+
+namespace dtlx
+{
+    /**
+     * @brief Callable that receives the edits of a diff one element at a time.
+     */
+    template <typename Sink, typename E>
+    concept SesSink = std::invocable<Sink&, const E&, const ElemInfo&>;
+
+    /**
+     * @brief Callable that receives the edits of a diff as runs of edits of the same type.
+     */
+    template <typename Sink>
+    concept EditRunSink = std::invocable<Sink&, const EditRun&>;
+}
+
+namespace dtlx::detail
+{
+    /**
+     * @class SinkRecorder
+     *
+     * @brief Passes each edit to a sink as soon as it is found.
+     *
+     * A part computed on another thread has no sink, it keeps its edits until it is appended in order.
+     */
+    template <Diffable E, SesSink<E> Sink>
+    class SinkRecorder
+    {
+    public:
+        explicit SinkRecorder(Sink* sink)
+            : m_sink{ sink }
+        {
+        }
+
+        void add(const E& elem, i64 index_before, i64 index_after, SesEdit type)
+        {
+            m_commons += type == SesEdit::Common;
+            emit(elem, { .index_before = index_before, .index_after = index_after, .type = type });
+        }
+
+        SinkRecorder part() const { return SinkRecorder{ nullptr }; }
+
+        void append(SinkRecorder&& other)
+        {
+            m_commons += other.m_commons;
+            for (const auto& [elem, info] : other.m_kept) {
+                emit(elem, info);
+            }
+        }
+
+        i64 lcs_size() const { return m_commons; }
+
+        void flush() {}
+
+    private:
+        void emit(const E& elem, const ElemInfo& info)
+        {
+            if (m_sink) {
+                (*m_sink)(elem, info);
+            } else {
+                m_kept.push_back({ elem, info });
+            }
+        }
+
+        Sink*                   m_sink;
+        std::vector<SesElem<E>> m_kept;
+        i64                     m_commons = 0;
+    };
+
+    /**
+     * @class RunSinkRecorder
+     *
+     * @brief Passes each run of edits to a sink as soon as the next edit does not continue it.
+     *
+     * The last run is only passed on `flush`. A part computed on another thread has no sink, it keeps its runs
+     * until it is appended in order.
+     */
+    template <EditRunSink Sink>
+    class RunSinkRecorder
+    {
+    public:
+        explicit RunSinkRecorder(Sink* sink)
+            : m_sink{ sink }
+        {
+        }
+
+        template <typename E>
+        void add(const E&, i64 index_before, i64 index_after, SesEdit type)
+        {
+            push({ .index_before = index_before, .index_after = index_after, .length = 1, .type = type });
+        }
+
+        void add_common(i64 index_before, i64 index_after, i64 length)
+        {
+            if (length > 0) {
+                push({
+                    .index_before = index_before,
+                    .index_after  = index_after,
+                    .length       = length,
+                    .type         = SesEdit::Common,
+                });
+            }
+        }
+
+        RunSinkRecorder part() const { return RunSinkRecorder{ nullptr }; }
+
+        void append(RunSinkRecorder&& other)
+        {
+            other.flush();
+            for (const auto& run : other.m_kept) {
+                push(run);
+            }
+        }
+
+        i64 lcs_size() const { return m_commons; }
+
+        void flush()
+        {
+            if (m_pending) {
+                emit(*m_pending);
+                m_pending.reset();
+            }
+        }
+
+    private:
+        void push(const EditRun& run)
+        {
+            if (run.type == SesEdit::Common) {
+                m_commons += run.length;
+            }
+
+            if (m_pending and m_pending->is_continued_by(run)) {
+                m_pending->length += run.length;
+            } else {
+                flush();
+                m_pending = run;
+            }
+        }
+
+        void emit(const EditRun& run)
+        {
+            if (m_sink) {
+                (*m_sink)(run);
+            } else {
+                m_kept.push_back(run);
+            }
+        }
+
+        Sink*                  m_sink;
+        std::optional<EditRun> m_pending;
+        std::vector<EditRun>   m_kept;
+        i64                    m_commons = 0;
+    };
+}
+
+#endif /* end of include guard: DTLX_SINK_HPP */
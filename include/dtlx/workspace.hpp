@@ -0,0 +1,130 @@
+#ifndef DTLX_WORKSPACE_HPP
+#define DTLX_WORKSPACE_HPP
+
+#include "dtlx/common.hpp"
+
+#include <concepts>
+#include <utility>
+#include <vector>
+
+namespace dtlx::detail
+{
+    /**
+     * @struct OnpBuffers
+     *
+     * @brief Working memory of the O(NP) algorithm.
+     */
+    template <std::signed_integral I>
+    struct OnpBuffers
+    {
+        std::vector<I>            furthest_points;
+        EditPath<I>               path;
+        EditPathCoords<KPoint<I>> path_coords;
+        EditPathCoords<Point<I>>  reduced_path_coords;
+
+        void release() noexcept
+        {
+            furthest_points     = {};
+            path                = {};
+            path_coords         = {};
+            reduced_path_coords = {};
+        }
+    };
+}
+
+namespace dtlx
+{
+    /**
+     * @class DiffWorkspace
+     *
+     * @brief Buffers used by the diff algorithm that are kept between calls.
+     *
+     * Passing the same workspace to many diffs lets them reuse the memory allocated by the previous ones, so
+     * diffing many sequences of similar sizes allocates only for the results. A workspace must not be used by
+     * more than one thread at a time; each thread has its own default one (see `default_workspace`).
+     */
+    class DiffWorkspace
+    {
+    public:
+        /**
+         * @class Lease
+         *
+         * @brief Buffers borrowed from a workspace for one run of the algorithm.
+         *
+         * If the workspace is already lent (e.g. a diff started from the comparison function of another diff),
+         * the lease owns fresh buffers instead.
+         */
+        template <std::signed_integral I>
+        class Lease
+        {
+        public:
+            explicit Lease(DiffWorkspace& workspace)
+                : m_owner{ workspace.m_lent ? nullptr : &workspace }
+                , m_buffers{ m_owner ? &workspace.buffers<I>() : &m_local }
+            {
+                if (m_owner) {
+                    m_owner->m_lent = true;
+                }
+            }
+
+            ~Lease()
+            {
+                if (m_owner) {
+                    m_owner->m_lent = false;
+                }
+            }
+
+            Lease(const Lease&)            = delete;
+            Lease& operator=(const Lease&) = delete;
+
+            detail::OnpBuffers<I>& operator*() noexcept { return *m_buffers; }
+            detail::OnpBuffers<I>* operator->() noexcept { return m_buffers; }
+
+        private:
+            DiffWorkspace*         m_owner;
+            detail::OnpBuffers<I>  m_local;
+            detail::OnpBuffers<I>* m_buffers;
+        };
+
+        template <std::signed_integral I>
+        Lease<I> lease()
+        {
+            return Lease<I>{ *this };
+        }
+
+        /**
+         * @brief Free the memory held by the workspace.
+         */
+        void release() noexcept
+        {
+            m_compact.release();
+            m_wide.release();
+        }
+
+    private:
+        template <std::signed_integral I>
+        detail::OnpBuffers<I>& buffers() noexcept
+        {
+            if constexpr (std::same_as<I, i32>) {
+                return m_compact;
+            } else {
+                return m_wide;
+            }
+        }
+
+        detail::OnpBuffers<i32> m_compact;
+        detail::OnpBuffers<i64> m_wide;
+        bool                    m_lent = false;
+    };
+
+    /**
+     * @brief The workspace used by the calling thread when none is given.
+     */
+    inline DiffWorkspace& default_workspace()
+    {
+        thread_local auto workspace = DiffWorkspace{};
+        return workspace;
+    }
+}
+
+#endif /* end of include guard: DTLX_WORKSPACE_HPP */
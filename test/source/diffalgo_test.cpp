@@ -0,0 +1,576 @@
+#include <dtlx/dtlx.hpp>
+
+#include <boost/ut.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ut = boost::ut;
+using namespace std::string_view_literals;
+
+struct AlgoTestCase
+{
+    std::string_view a;
+    std::string_view b;
+};
+
+constexpr auto g_test_cases = std::array{
+    AlgoTestCase{ "abc", "abd" },
+    AlgoTestCase{ "acbdeacbed", "acebdabbabed" },
+    AlgoTestCase{ "abcdef", "dacfea" },
+    AlgoTestCase{ "abcbda", "bdcaba" },
+    AlgoTestCase{ "bokko", "bokkko" },
+    AlgoTestCase{ "", "" },
+    AlgoTestCase{ "a", "" },
+    AlgoTestCase{ "", "b" },
+    AlgoTestCase{ "abc", "xyz" },
+    AlgoTestCase{ "abcqqqeqqqccc", "abdqqqeqqqddd" },
+    AlgoTestCase{ "acbdeaqqqqqqqcbed", "acebdabbqqqqqqqabed" },
+    AlgoTestCase{
+        "abcdefq3wefarhgorequgho4euhfteowauhfwehogfewrquhoi23hroewhoahfotrhguoiewahrgqqabcdef",
+        "3abcdef4976fd86ouofita67t85r876e5e746578tgliuhopoqqabcdef",
+    },
+};
+
+// the indices of a valid SES are increasing by one on each side
+bool ses_indices_valid(const dtlx::Ses<char>& ses)
+{
+    auto before = dtlx::i64{ 0 };
+    auto after  = dtlx::i64{ 0 };
+
+    for (const auto& [elem, info] : ses.get()) {
+        switch (info.type) {
+        case dtlx::SesEdit::Delete: {
+            if (info.index_before != ++before or info.index_after != 0) {
+                return false;
+            }
+        } break;
+        case dtlx::SesEdit::Add: {
+            if (info.index_before != 0 or info.index_after != ++after) {
+                return false;
+            }
+        } break;
+        case dtlx::SesEdit::Common: {
+            if (info.index_before != ++before or info.index_after != ++after) {
+                return false;
+            }
+        } break;
+        }
+    }
+
+    return true;
+}
+
+// generate a pair of long strings that differ in many places
+void generate_long_case(std::string& a, std::string& b, std::size_t len)
+{
+    auto state = 0x1234'5678u;
+    auto next  = [&] {
+        state = state * 1'103'515'245u + 12'345u;
+        return (state >> 16) & 0x7FFF;
+    };
+
+    for (auto i = 0u; i < len; ++i) {
+        auto ch = static_cast<char>('a' + next() % 4);
+        a.push_back(ch);
+
+        switch (next() % 8) {
+        case 0: /* delete */ break;
+        case 1: b.append({ ch, 'x' }); break;
+        case 2: b.push_back(static_cast<char>('a' + next() % 4)); break;
+        default: b.push_back(ch);
+        }
+    }
+}
+
+int main()
+{
+    using ut::expect, ut::fatal, ut::that;
+    using namespace ut::literals;
+    using namespace ut::operators;
+
+    "linear space diff should produce a minimal and valid SES"_test = [](const auto& tcase) {
+        const auto& [a, b] = tcase;
+
+        for (auto threads : { 1u, 4u }) {
+            auto flags = dtlx::DiffFlags{ .algorithm = dtlx::DiffAlgorithm::Linear, .threads = threads };
+            auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+            expect(that % edit_dist == dtlx::edit_distance(a, b)) << fmt::format("{} | {}", a, b);
+            expect(ses_indices_valid(ses)) << fmt::format("{} | {}", a, b);
+
+            auto patched = dtlx::patch<std::basic_string>(a, ses);
+            expect(that % b == patched) << fmt::format("{} | {}", a, b);
+        }
+    } | g_test_cases;
+
+    "patience diff should produce a valid SES"_test = [](const auto& tcase) {
+        const auto& [a, b] = tcase;
+
+        for (auto limit : { dtlx::constants::default_limit, std::size_t{ 4 } }) {
+            auto flags = dtlx::DiffFlags{ .limit = limit, .algorithm = dtlx::DiffAlgorithm::Patience };
+            auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+            expect(that % edit_dist >= dtlx::edit_distance(a, b)) << fmt::format("{} | {}", a, b);
+            expect(that % edit_dist == std::ssize(a) + std::ssize(b) - 2 * std::ssize(lcs.get()))
+                << fmt::format("{} | {}", a, b);
+            expect(ses_indices_valid(ses)) << fmt::format("{} | {}", a, b);
+
+            auto patched = dtlx::patch<std::basic_string>(a, ses);
+            expect(that % b == patched) << fmt::format("{} | {}", a, b);
+        }
+    } | g_test_cases;
+
+    "patience diff should match lines that occur once"_test = [] {
+        // "x" is the only line that occurs once, it is matched even though matching the braces is shorter
+        auto a = std::vector<std::string_view>{ "x", "}", "}", "}" };
+        auto b = std::vector<std::string_view>{ "}", "}", "}", "x" };
+
+        auto flags = dtlx::DiffFlags{ .algorithm = dtlx::DiffAlgorithm::Patience };
+        auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+        expect(that % edit_dist == 6);
+        expect(std::ranges::equal(lcs.get(), std::array{ "x"sv }));
+        expect(dtlx::patch<std::vector>(a, ses) == b);
+    };
+
+    "histogram diff should produce a valid SES"_test = [](const auto& tcase) {
+        const auto& [a, b] = tcase;
+
+        for (auto limit : { dtlx::constants::default_limit, std::size_t{ 4 } }) {
+            auto flags = dtlx::DiffFlags{ .limit = limit, .algorithm = dtlx::DiffAlgorithm::Histogram };
+            auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+            expect(that % edit_dist >= dtlx::edit_distance(a, b)) << fmt::format("{} | {}", a, b);
+            expect(that % edit_dist == std::ssize(a) + std::ssize(b) - 2 * std::ssize(lcs.get()))
+                << fmt::format("{} | {}", a, b);
+            expect(ses_indices_valid(ses)) << fmt::format("{} | {}", a, b);
+
+            auto patched = dtlx::patch<std::basic_string>(a, ses);
+            expect(that % b == patched) << fmt::format("{} | {}", a, b);
+        }
+    } | g_test_cases;
+
+    "histogram diff should split on the least frequent element"_test = [] {
+        // no line occurs once on both sides, but "x" occurs twice against five "}"
+        auto a = std::vector<std::string_view>{ "x", "}", "}", "}", "}", "}", "x" };
+        auto b = std::vector<std::string_view>{ "}", "}", "x", "}", "}", "x", "}" };
+
+        auto onp       = dtlx::diff(a, b);
+        auto patience  = dtlx::diff(a, b, {}, { .algorithm = dtlx::DiffAlgorithm::Patience });
+        auto histogram = dtlx::diff(a, b, {}, { .algorithm = dtlx::DiffAlgorithm::Histogram });
+
+        // patience has no anchor and falls back to O(NP), which matches the braces
+        expect(patience == onp);
+        expect(that % onp.edit_distance == 4);
+        expect(std::ranges::equal(onp.lcs.get(), std::array{ "}"sv, "}"sv, "}"sv, "}"sv, "x"sv }));
+
+        // histogram matches the first "x" and the braces after it
+        expect(histogram.ses != onp.ses);
+        expect(that % histogram.edit_distance == 6);
+        expect(std::ranges::equal(histogram.lcs.get(), std::array{ "x"sv, "}"sv, "}"sv, "}"sv }));
+        expect(dtlx::patch<std::vector>(a, histogram.ses) == b);
+    };
+
+    "histogram diff should fall back to O(NP) when every element is too frequent"_test = [] {
+        auto a = std::string{};
+        auto b = std::string{};
+
+        generate_long_case(a, b, 2'000);    // only 5 distinct characters
+
+        auto histogram = dtlx::diff(a, b, {}, { .algorithm = dtlx::DiffAlgorithm::Histogram });
+        auto onp       = dtlx::diff(a, b, {}, { .trim_suffix = true });
+
+        expect(histogram == onp);
+    };
+
+    "linear space diff should be exact on large inputs regardless of threads"_test = [] {
+        auto a = std::string{};
+        auto b = std::string{};
+
+        generate_long_case(a, b, 40'000);
+        auto expected = dtlx::edit_distance(a, b);
+
+        for (auto threads : { 1u, 2u, 8u }) {
+            auto flags = dtlx::DiffFlags{ .algorithm = dtlx::DiffAlgorithm::Linear, .threads = threads };
+            auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+            expect(that % edit_dist == expected) << fmt::format("threads: {}", threads);
+            expect(ses_indices_valid(ses)) << fmt::format("threads: {}", threads);
+            expect(dtlx::patch<std::basic_string>(a, ses) == b) << fmt::format("threads: {}", threads);
+        }
+    };
+
+    "cost limited diff should produce a valid SES"_test = [](const auto& tcase) {
+        const auto& [a, b] = tcase;
+
+        for (auto cost_limit : { std::size_t{ 1 }, std::size_t{ 2 }, std::size_t{ 8 } }) {
+            auto flags = dtlx::DiffFlags{ .cost_limit = cost_limit };
+            auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+            expect(that % edit_dist >= dtlx::edit_distance(a, b)) << fmt::format("{} | {}", a, b);
+            expect(that % edit_dist == std::ssize(a) + std::ssize(b) - 2 * std::ssize(lcs.get()))
+                << fmt::format("{} | {}", a, b);
+            expect(ses_indices_valid(ses)) << fmt::format("{} | {}", a, b);
+
+            auto patched = dtlx::patch<std::basic_string>(a, ses);
+            expect(that % b == patched) << fmt::format("{} | {}", a, b);
+        }
+    } | g_test_cases;
+
+    "cost limited diff should be minimal when the cost is not reached"_test = [] {
+        auto a = std::string{};
+        auto b = std::string{};
+        generate_long_case(a, b, 2'000);
+
+        auto expected = dtlx::diff(a, b);
+        auto result   = dtlx::diff(a, b, {}, { .cost_limit = a.size() });
+        expect(result == expected);
+
+        auto limited = dtlx::diff(a, b, {}, { .cost_limit = 4 });
+        expect(that % limited.edit_distance > expected.edit_distance);
+        expect(that % dtlx::patch<std::basic_string>(a, limited.ses) == b);
+    };
+
+    "diff should be the same with 32-bit and 64-bit indices"_test = [] {
+        auto a = std::string{};
+        auto b = std::string{};
+        generate_long_case(a, b, 5'000);
+
+        // neither limit is reached, but one that does not fit in 32 bits forces 64-bit indices
+        auto compact = dtlx::diff(a, b, {}, { .limit = std::numeric_limits<dtlx::i32>::max() / 2 });
+        auto wide    = dtlx::diff(a, b, {}, { .limit = dtlx::constants::no_limit });
+
+        expect(compact == wide);
+    };
+
+    "diff with a reused workspace should be the same as without"_test = [] {
+        auto workspace = dtlx::DiffWorkspace{};
+
+        for (const auto& [a, b] : g_test_cases) {
+            auto expected = dtlx::diff(a, b);
+            auto result   = dtlx::diff(a, b, {}, { .workspace = &workspace });
+
+            expect(result == expected) << fmt::format("{} | {}", a, b);
+            expect(that % dtlx::edit_distance(a, b, std::equal_to<>{}, workspace) == expected.edit_distance)
+                << fmt::format("{} | {}", a, b);
+
+            // the calling thread of a parallel diff uses the given workspace too
+            auto parallel = dtlx::DiffFlags{ .threads = 4, .min_segment_size = 1 };
+            auto lent     = dtlx::DiffFlags{ .threads = 4, .min_segment_size = 1, .workspace = &workspace };
+
+            expect(dtlx::diff(a, b, {}, lent) == dtlx::diff(a, b, {}, parallel)) << fmt::format("{} | {}", a, b);
+        }
+
+        // a diff run from the comparison function gets its own buffers instead of the ones in use
+        auto nested = [](std::string_view l, std::string_view r) { return dtlx::diff(l, r).edit_distance == 0; };
+
+        auto a = std::vector<std::string_view>{ "ab", "cd", "ef", "gh" };
+        auto b = std::vector<std::string_view>{ "ab", "ef", "xy", "gh" };
+
+        auto expected = dtlx::diff(a, b);
+        auto result   = dtlx::diff(a, b, nested);
+        expect(that % result.edit_distance == expected.edit_distance);
+        expect(result.ses == expected.ses);
+    };
+
+    "diff with a memory resource should allocate the result from it"_test = [] {
+        auto buffer    = std::vector<std::byte>(1 << 20);
+        auto in_buffer = [&](const void* ptr) {
+            auto* byte = static_cast<const std::byte*>(ptr);
+            return byte >= buffer.data() and byte < buffer.data() + buffer.size();
+        };
+
+        using Algo = dtlx::DiffAlgorithm;
+
+        for (auto algorithm : { Algo::Onp, Algo::Linear, Algo::Patience, Algo::Histogram }) {
+            for (const auto& [a, b] : g_test_cases) {
+                // nothing outside of the buffer can be allocated from the arena
+                auto arena = std::pmr::monotonic_buffer_resource{
+                    buffer.data(), buffer.size(), std::pmr::null_memory_resource()
+                };
+
+                auto flags    = dtlx::DiffFlags{ .algorithm = algorithm };
+                auto expected = dtlx::unidiff(a, b, {}, flags);
+
+                flags.resource = &arena;
+                auto result    = dtlx::unidiff(a, b, {}, flags);
+
+                expect(result == expected) << fmt::format("{} | {}", a, b);
+                expect(result.ses.get().empty() or in_buffer(result.ses.get().data()));
+                expect(result.lcs.get().empty() or in_buffer(result.lcs.get().data()));
+                expect(result.uni_hunks.get().empty() or in_buffer(result.uni_hunks.get().data()));
+            }
+        }
+    };
+
+    "index diff should be the same as diff"_test = [] {
+        using Algo = dtlx::DiffAlgorithm;
+
+        for (auto algorithm : { Algo::Onp, Algo::Linear, Algo::Patience, Algo::Histogram }) {
+            for (const auto& [a, b] : g_test_cases) {
+                auto flags    = dtlx::DiffFlags{ .algorithm = algorithm };
+                auto expected = dtlx::diff(a, b, {}, flags);
+                auto result   = dtlx::diff_index(a, b, {}, flags);
+
+                expect(that % result.edit_distance == expected.edit_distance) << fmt::format("{} | {}", a, b);
+                expect(result.ses.to_ses(a, b) == expected.ses) << fmt::format("{} | {}", a, b);
+            }
+        }
+    };
+
+    "index diff should work on elements that can not be copied"_test = [] {
+        auto to_owned = [](std::string_view str) {
+            auto owned = std::vector<std::unique_ptr<char>>{};
+            for (auto ch : str) {
+                owned.push_back(std::make_unique<char>(ch));
+            }
+            return owned;
+        };
+
+        auto comp = [](const std::unique_ptr<char>& l, const std::unique_ptr<char>& r) { return *l == *r; };
+
+        for (const auto& [a, b] : g_test_cases) {
+            auto lhs = to_owned(a);
+            auto rhs = to_owned(b);
+
+            auto expected = dtlx::diff(a, b);
+            auto result   = dtlx::diff_index(lhs, rhs, comp);
+
+            expect(that % result.edit_distance == expected.edit_distance) << fmt::format("{} | {}", a, b);
+            expect((that % result.ses.get().size() == expected.ses.get().size()) >> fatal);
+
+            for (auto i = 0u; i < result.ses.get().size(); ++i) {
+                const auto& info = result.ses.get()[i];
+                const auto& elem = expected.ses.get()[i];
+
+                expect(info == elem.info) << fmt::format("{} | {}", a, b);
+                expect(that % *dtlx::IndexSes::elem(info, lhs, rhs) == elem.elem) << fmt::format("{} | {}", a, b);
+            }
+        }
+    };
+
+    "run diff should be the same as diff"_test = [] {
+        using Algo = dtlx::DiffAlgorithm;
+
+        for (auto algorithm : { Algo::Onp, Algo::Linear, Algo::Patience, Algo::Histogram }) {
+            for (const auto& [a, b] : g_test_cases) {
+                auto flags    = dtlx::DiffFlags{ .algorithm = algorithm };
+                auto expected = dtlx::diff(a, b, {}, flags);
+                auto result   = dtlx::diff_runs(a, b, {}, flags);
+
+                expect(that % result.edit_distance == expected.edit_distance) << fmt::format("{} | {}", a, b);
+                expect(result.ses.to_ses(a) == expected.ses) << fmt::format("{} | {}", a, b);
+                expect(dtlx::ses_to_unidiff(result.ses, a) == dtlx::ses_to_unidiff(expected.ses))
+                    << fmt::format("{} | {}", a, b);
+                expect(that % dtlx::patch<std::basic_string>(a, result.ses) == b) << fmt::format("{} | {}", a, b);
+            }
+        }
+    };
+
+    "run diff should store consecutive edits as one run"_test = [] {
+        auto a = std::string(10'000, 'a') + "xyz" + std::string(50'000, 'b');
+        auto b = std::string(10'000, 'a') + "uv" + std::string(50'000, 'b');
+
+        auto [ses, edit_dist] = dtlx::diff_runs(a, b);
+
+        expect(that % edit_dist == 5);
+        expect(that % ses.get().size() == 4u);
+        expect(that % ses.size() == std::ssize(a) + 2);
+        expect(std::ranges::equal(ses.added(), "uv"sv));
+    };
+
+    "diff to a sink should receive the same edits as diff"_test = [] {
+        using Algo = dtlx::DiffAlgorithm;
+
+        for (auto algorithm : { Algo::Onp, Algo::Linear, Algo::Patience, Algo::Histogram }) {
+            for (auto threads : { 1u, 4u }) {
+                for (const auto& [a, b] : g_test_cases) {
+                    auto flags = dtlx::DiffFlags{
+                        .algorithm        = algorithm,
+                        .threads          = threads,
+                        .min_segment_size = 1,
+                    };
+                    auto expected      = dtlx::diff(a, b, {}, flags);
+                    auto expected_runs = dtlx::diff_runs(a, b, {}, flags);
+
+                    auto elems     = std::vector<dtlx::SesElem<char>>{};
+                    auto elem_sink = [&](char elem, const dtlx::ElemInfo& info) {
+                        elems.push_back({ elem, info });
+                    };
+                    auto edit_dist = dtlx::diff_to(a, b, elem_sink, {}, flags);
+
+                    expect(that % edit_dist == expected.edit_distance) << fmt::format("{} | {}", a, b);
+                    expect(std::ranges::equal(elems, expected.ses.get())) << fmt::format("{} | {}", a, b);
+
+                    auto runs     = std::vector<dtlx::EditRun>{};
+                    auto run_sink = [&](const dtlx::EditRun& run) { runs.push_back(run); };
+                    edit_dist     = dtlx::diff_to(a, b, run_sink, {}, flags);
+
+                    expect(that % edit_dist == expected.edit_distance) << fmt::format("{} | {}", a, b);
+                    expect(std::ranges::equal(runs, expected_runs.ses.get())) << fmt::format("{} | {}", a, b);
+                }
+            }
+        }
+    };
+
+    "diff view should be the same as diff"_test = [] {
+        using Algo = dtlx::DiffAlgorithm;
+
+        for (auto algorithm : { Algo::Onp, Algo::Linear, Algo::Patience, Algo::Histogram }) {
+            for (auto limit : { dtlx::constants::default_limit, std::size_t{ 4 } }) {
+                for (const auto& [a, b] : g_test_cases) {
+                    auto flags         = dtlx::DiffFlags{ .limit = limit, .algorithm = algorithm };
+                    auto expected      = dtlx::diff(a, b, {}, flags);
+                    auto expected_runs = dtlx::diff_runs(a, b, {}, flags);
+
+                    auto huge = flags;
+                    huge.huge = true;
+                    expect(std::ranges::equal(dtlx::diff_view(a, b, {}, huge), expected.ses.get()))
+                        << fmt::format("{} | {}", a, b);
+
+                    auto elems = std::vector<dtlx::SesElem<char>>{};
+                    std::ranges::copy(dtlx::diff_view(a, b, {}, flags), std::back_inserter(elems));
+
+                    auto runs = std::vector<dtlx::EditRun>{};
+                    std::ranges::copy(dtlx::diff_runs_view(a, b, {}, flags), std::back_inserter(runs));
+
+                    expect(std::ranges::equal(elems, expected.ses.get())) << fmt::format("{} | {}", a, b);
+                    expect(std::ranges::equal(runs, expected_runs.ses.get())) << fmt::format("{} | {}", a, b);
+                }
+            }
+        }
+    };
+
+    "diff view should only compute the part of the SES that is read"_test = [] {
+        auto a = std::string{};
+        auto b = std::string{};
+
+        generate_long_case(a, b, 20'000);
+
+        auto comparisons = 0;
+        auto comp        = [&](char lhs, char rhs) {
+            ++comparisons;
+            return lhs == rhs;
+        };
+
+        auto flags = dtlx::DiffFlags{ .limit = 1'000 };
+        auto view  = dtlx::diff_view(a, b, comp, flags);
+        auto first = *std::ranges::find_if(view, [](const auto& elem) {
+            return elem.info.type != dtlx::SesEdit::Common;
+        });
+
+        auto lazy_comparisons = std::exchange(comparisons, 0);
+        auto expected         = dtlx::diff(a, b, comp, flags);
+
+        expect(first == *std::ranges::find_if(expected.ses.get(), [](const auto& elem) {
+            return elem.info.type != dtlx::SesEdit::Common;
+        }));
+        expect(that % lazy_comparisons < comparisons / 10);
+    };
+
+    "diff view with the default flags should only be lazy up to the end of the common prefix"_test = [] {
+        auto a = std::string(5'000, 'p');
+        auto b = std::string(5'000, 'p');
+
+        generate_long_case(a, b, 2'000);    // small enough for one segment of the default limit
+
+        auto prefix      = std::ranges::mismatch(a, b).in1 - a.begin();
+        auto comparisons = 0;
+        auto comp        = [&](char lhs, char rhs) {
+            ++comparisons;
+            return lhs == rhs;
+        };
+
+        auto count_until = [&](auto pred) {
+            comparisons = 0;
+            std::ranges::find_if(dtlx::diff_view(a, b, comp), pred);
+            return comparisons;
+        };
+
+        auto in_prefix  = count_until([](const auto&) { return true; });
+        auto first_edit = count_until([](const auto& elem) { return elem.info.type != dtlx::SesEdit::Common; });
+
+        comparisons   = 0;
+        auto expected = dtlx::diff(a, b, comp);
+
+        // the prefix is found on its own, everything after it in one segment of the default limit
+        expect(that % in_prefix == prefix + 1);
+        expect(that % first_edit == comparisons) << fmt::format("edit distance: {}", expected.edit_distance);
+    };
+
+    "batch diff should be the same as diff of each pair"_test = [] {
+        auto pairs = std::vector<std::pair<std::string_view, std::string_view>>{};
+        for (const auto& [a, b] : g_test_cases) {
+            pairs.emplace_back(a, b);
+            pairs.emplace_back(b, a);
+        }
+
+        for (auto threads : { 1u, 4u }) {
+            auto results   = dtlx::diff_batch(pairs, {}, {}, threads);
+            auto distances = dtlx::edit_distance_batch(pairs, std::equal_to<>{}, threads);
+            auto unidiffs  = dtlx::unidiff_batch(pairs, {}, {}, threads);
+
+            auto received = std::vector<int>(pairs.size());
+            auto mutex    = std::mutex{};
+            auto on_diff  = [&](std::size_t i, dtlx::DiffResult<char>&& result) {
+                auto lock = std::unique_lock{ mutex };
+                received[i] += result == results[i] ? 1 : -1;
+            };
+            dtlx::diff_batch_to(pairs, on_diff, {}, {}, threads);
+
+            for (std::size_t i = 0; i < pairs.size(); ++i) {
+                const auto& [a, b] = pairs[i];
+
+                expect(results[i] == dtlx::diff(a, b)) << fmt::format("{} | {}", a, b);
+                expect(that % distances[i] == dtlx::edit_distance(a, b)) << fmt::format("{} | {}", a, b);
+                expect(unidiffs[i] == dtlx::unidiff(a, b)) << fmt::format("{} | {}", a, b);
+                expect(that % received[i] == 1) << fmt::format("{} | {}", a, b);
+            }
+        }
+    };
+
+    "parallel diff should produce a valid SES regardless of segment size"_test = [] {
+        auto a = std::vector<int>{};
+        auto b = std::vector<int>{};
+
+        auto state = 0x9abc'def0u;
+        auto next  = [&] {
+            state = state * 1'103'515'245u + 12'345u;
+            return static_cast<int>((state >> 16) & 0x7FFF);
+        };
+
+        // every 5th element is unique so that the sequences can be segmented on them
+        for (auto i = 0; i < 20'000; ++i) {
+            auto value = i % 5 == 0 ? 256 + i : next() % 4;
+            a.push_back(value);
+
+            switch (next() % 8) {
+            case 0: /* delete */ break;
+            case 1: b.insert(b.end(), { value, next() % 4 }); break;
+            default: b.push_back(value);
+            }
+        }
+
+        for (auto min_segment_size : { 1u, 64u, 4096u, 1'000'000u }) {
+            auto flags = dtlx::DiffFlags{ .threads = 4, .min_segment_size = min_segment_size };
+            auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, flags);
+
+            auto name = fmt::format("min_segment_size: {}", min_segment_size);
+
+            expect(that % edit_dist >= dtlx::edit_distance(a, b)) << name;
+            expect(that % edit_dist == std::ssize(a) + std::ssize(b) - 2 * std::ssize(lcs.get())) << name;
+            expect(dtlx::patch<std::vector>(a, ses) == b) << name;
+        }
+    };
+}
@@ -0,0 +1,137 @@
+#include <dtlx/dtlx.hpp>
+
+#include <boost/ut.hpp>
+#include <fmt/core.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ut = boost::ut;
+
+struct DistanceTestCase
+{
+    std::string_view a;
+    std::string_view b;
+    dtlx::i64        levenshtein;
+};
+
+constexpr auto g_test_cases = std::array{
+    DistanceTestCase{ "abc", "abd", 1 },
+    DistanceTestCase{ "kitten", "sitting", 3 },
+    DistanceTestCase{ "acbdeacbed", "acebdabbabed", 5 },
+    DistanceTestCase{ "abcdef", "dacfea", 4 },
+    DistanceTestCase{ "bokko", "bokkko", 1 },
+    DistanceTestCase{ "", "", 0 },
+    DistanceTestCase{ "a", "", 1 },
+    DistanceTestCase{ "", "b", 1 },
+    DistanceTestCase{ "abc", "xyz", 3 },
+    DistanceTestCase{ "abcqqqeqqqccc", "abdqqqeqqqddd", 4 },
+};
+
+// the O(NP) algorithm is the reference, comparing with a custom comparator never uses bit-vectors
+struct CharEqual
+{
+    bool operator()(char a, char b) const { return a == b; }
+};
+
+std::string generate_string(std::uint32_t seed, std::size_t len)
+{
+    auto str = std::string{};
+    for (auto i = 0u; i < len; ++i) {
+        seed = seed * 1'103'515'245u + 12'345u;
+        str.push_back(static_cast<char>('a' + ((seed >> 16) % 4)));
+    }
+    return str;
+}
+
+int main()
+{
+    using ut::expect, ut::that;
+    using namespace ut::literals;
+    using namespace ut::operators;
+
+    "edit distance of integral elements should be the same as O(NP) edit distance"_test = [](const auto& tcase) {
+        auto [a, b, _] = tcase;
+
+        auto expected = dtlx::edit_distance(a, b, CharEqual{});
+        auto result   = dtlx::edit_distance(a, b);
+        expect(that % result == expected) << fmt::format("a: {:?}, b: {:?}", a, b);
+    } | g_test_cases;
+
+    "edit distance should be the same as O(NP) edit distance across multiple blocks"_test = [](std::size_t len) {
+        auto a = generate_string(0x1234'5678u, len);
+        auto b = generate_string(0x8765'4321u, len / 2 + 3);
+
+        auto expected = dtlx::edit_distance(a, b, CharEqual{});
+
+        auto result = dtlx::edit_distance(a, b);
+        expect(that % result == expected) << fmt::format("len: {}", len);
+
+        auto wide_a = std::vector<int>(a.begin(), a.end());
+        auto wide_b = std::vector<int>(b.begin(), b.end());
+        auto wide   = dtlx::edit_distance(wide_a, wide_b);
+        expect(that % wide == expected) << fmt::format("len: {}", len);
+    } | std::vector<std::size_t>{ 63, 64, 65, 128, 200, 500 };
+
+    "edit distance of bool elements should be the same as O(NP) edit distance"_test = [] {
+        auto a = std::array{ true, false, true };
+        auto b = std::array{ true, true };
+
+        auto onp = dtlx::edit_distance(a, b, [](bool lhs, bool rhs) { return lhs == rhs; });
+        expect(that % onp == 1);
+        expect(that % dtlx::edit_distance(a, b) == onp);
+        expect(that % dtlx::levenshtein_distance(a, b) == 1);
+
+        auto long_a = std::vector<bool>(100, true);
+        auto long_b = std::vector<bool>(90, false);
+        expect(that % dtlx::edit_distance(long_a, long_b) == 190);
+        expect(that % dtlx::levenshtein_distance(long_a, long_b) == 100);
+    };
+
+    "bounded edit distance should only be returned when it is within the bound"_test = [](const auto& tcase) {
+        auto [a, b, _] = tcase;
+
+        auto distance = dtlx::edit_distance(a, b);
+
+        for (auto max_distance : { distance - 1, distance, distance + 3 }) {
+            auto expected = max_distance >= distance ? std::optional{ distance } : std::nullopt;
+
+            auto bit_parallel = dtlx::edit_distance_within(a, b, max_distance);
+            auto onp          = dtlx::edit_distance_within(a, b, max_distance, CharEqual{});
+
+            expect(bit_parallel == expected) << fmt::format("a: {:?}, b: {:?}, max: {}", a, b, max_distance);
+            expect(onp == expected) << fmt::format("a: {:?}, b: {:?}, max: {}", a, b, max_distance);
+        }
+    } | g_test_cases;
+
+    "bounded edit distance should reject ranges with a larger size difference"_test = [] {
+        auto a = std::string(1'000, 'a');
+        auto b = std::string(10, 'a');
+
+        expect(dtlx::edit_distance_within(a, b, 989) == std::nullopt);
+        expect(dtlx::edit_distance_within(a, b, 990) == std::optional<dtlx::i64>{ 990 });
+    };
+
+    "levenshtein distance should count a substitution as one edit"_test = [](const auto& tcase) {
+        auto [a, b, levenshtein] = tcase;
+
+        auto bit_parallel = dtlx::levenshtein_distance(a, b);
+        auto generic      = dtlx::levenshtein_distance(a, b, CharEqual{});
+
+        expect(that % bit_parallel == levenshtein) << fmt::format("a: {:?}, b: {:?}", a, b);
+        expect(that % generic == levenshtein) << fmt::format("a: {:?}, b: {:?}", a, b);
+    } | g_test_cases;
+
+    "levenshtein distance should be the same with and without bit-vectors"_test = [](std::size_t len) {
+        auto a = generate_string(0x1234'5678u, len);
+        auto b = generate_string(0x8765'4321u, len + 17);
+
+        auto bit_parallel = dtlx::levenshtein_distance(a, b);
+        auto generic      = dtlx::levenshtein_distance(a, b, CharEqual{});
+        expect(that % bit_parallel == generic) << fmt::format("len: {}", len);
+    } | std::vector<std::size_t>{ 63, 64, 65, 128, 200, 500 };
+}
@@ -6,6 +6,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <sstream>
 #include <string_view>
 
@@ -113,4 +114,41 @@ int main(int /* argc */, char** argv)
             };
         }
     }
+
+    test("diff on interned lines should be the same as diff on lines") = [&] {
+        auto table = dtlx::InternTable<std::string_view>{};
+
+        auto expected = dtlx::diff(file1_lines, file2_lines);
+        auto result   = dtlx::diff(file1_lines, file2_lines, table);
+
+        expect(that % result.edit_distance == expected.edit_distance);
+        expect(result.lcs == expected.lcs);
+        expect(result.ses == expected.ses);
+
+        // reuse the table and the interned lines on both sides
+        auto interned = table.intern(file1_lines);
+        auto swapped  = dtlx::diff(file2_lines, interned, table);
+
+        expect(swapped == dtlx::diff(file2_lines, file1_lines));
+        expect(that % dtlx::edit_distance(interned, file2_lines, table) == expected.edit_distance);
+    };
+
+    test("diff against a prepared base should be the same as diff on lines") = [&] {
+        auto base = dtlx::PreparedSequence{ file1_lines };
+
+        auto result  = dtlx::diff(base, file2_lines);
+        auto swapped = dtlx::diff(file2_lines, base);
+
+        expect(result == dtlx::diff(file1_lines, file2_lines));
+        expect(swapped == dtlx::diff(file2_lines, file1_lines));
+        expect(that % dtlx::edit_distance(base, file2_lines) == result.edit_distance);
+        expect(that % dtlx::edit_distance(file2_lines, base) == swapped.edit_distance);
+
+        // the base can be diffed against many sequences concurrently
+        auto other   = LineByLineView{ file2_lines.rbegin(), file2_lines.rend() };
+        auto pending = std::async(std::launch::async, [&] { return dtlx::diff(base, other); });
+
+        expect(dtlx::diff(base, file2_lines) == result);
+        expect(pending.get() == dtlx::diff(file1_lines, other));
+    };
 }
@@ -0,0 +1,106 @@
+#include <dtlx/detail/snake.hpp>
+
+#include <boost/ut.hpp>
+#include <fmt/core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ut = boost::ut;
+
+// the first mismatches around the 16 and 32 byte blocks, and a few past them
+constexpr auto g_mismatch_offsets = std::array<std::size_t, 11>{ 0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 64 };
+
+template <typename T>
+std::size_t common_run_naive(const T* lhs, const T* rhs, std::size_t size)
+{
+    auto i = std::size_t{ 0 };
+    while (i < size and lhs[i] == rhs[i]) {
+        ++i;
+    }
+    return i;
+}
+
+template <typename T>
+std::vector<T> make_sequence(std::size_t size)
+{
+    auto seq = std::vector<T>(size);
+    for (auto i = std::size_t{ 0 }; i < size; ++i) {
+        seq[i] = static_cast<T>(i * 37 + 11);
+    }
+    return seq;
+}
+
+// the sequences start one element into their buffers so that the loads are not aligned
+template <typename T>
+void check_common_run(std::size_t size, std::size_t mismatch, T flip)
+{
+    using ut::expect, ut::that;
+
+    auto lhs = make_sequence<T>(size + 1);
+    auto rhs = lhs;
+
+    if (mismatch < size) {
+        rhs[mismatch + 1] = static_cast<T>(rhs[mismatch + 1] ^ flip);
+    }
+
+    auto expected = common_run_naive(lhs.data() + 1, rhs.data() + 1, size);
+    auto result   = dtlx::detail::common_run(lhs.data() + 1, rhs.data() + 1, size);
+
+    expect(that % result == expected) << fmt::format(
+        "element size: {}, size: {}, mismatch: {}, flip: {:#x}",
+        sizeof(T),
+        size,
+        mismatch,
+        static_cast<std::uint64_t>(flip)
+    );
+}
+
+template <typename T>
+void check_common_runs()
+{
+    // sizes that end inside a block as well as on its boundary
+    for (auto mismatch : g_mismatch_offsets) {
+        for (auto size : { mismatch + 1, mismatch + 2, mismatch + 5, mismatch + 16, mismatch + 33 }) {
+            check_common_run<T>(size, mismatch, T{ 1 });
+
+            // only the highest byte of a wider element differs
+            if constexpr (sizeof(T) > 1) {
+                check_common_run<T>(size, mismatch, static_cast<T>(T{ 1 } << (8 * sizeof(T) - 1)));
+            }
+        }
+    }
+
+    // no mismatch at all, the whole size is common
+    for (auto size = std::size_t{ 0 }; size <= 70; ++size) {
+        check_common_run<T>(size, size, T{ 1 });
+    }
+}
+
+int main()
+{
+    using ut::expect, ut::that;
+    using namespace ut::literals;
+    using namespace ut::operators;
+
+    // the vector kernels are compiled in depending on the target (-mavx2 for the 32 byte one), this test is also
+    // built with DTLX_DISABLE_SIMD for the word at a time one
+
+    "common run should stop at the first mismatch of single byte elements"_test = [] {
+        check_common_runs<std::uint8_t>();
+        check_common_runs<char>();
+    };
+
+    "common run should stop at the first mismatching element of multi-byte elements"_test = [] {
+        check_common_runs<std::uint16_t>();
+        check_common_runs<std::int32_t>();
+        check_common_runs<std::uint64_t>();
+    };
+
+    "common run should compare nothing for an empty range"_test = [] {
+        auto seq = make_sequence<int>(1);
+        expect(that % dtlx::detail::common_run(seq.data(), seq.data(), 0) == 0u);
+    };
+}
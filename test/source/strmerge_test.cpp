@@ -3,10 +3,19 @@
 #include <boost/ut.hpp>
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace ut = boost::ut;
+using namespace std::string_view_literals;
 
 struct MergeTestCase
 {
@@ -41,18 +50,79 @@ constexpr auto g_merge_success = std::array{
     MergeTestCase{ "acdef", "abcdef", "abcdf", "acdf" },
     MergeTestCase{ "acdef", "abcdef", "abcdfaa", "acdfaa" },
     MergeTestCase{ "abcdfaa", "abcdef", "acdef", "acdfaa" },
-
+    // the diffs are not split on elements that occur once on both sides by default
+    MergeTestCase{ "baaabba", "baaabaaabba", "baaabaaab", "baaabb" },
+    MergeTestCase{ "aab", "abbaab", "abbbbaaaaab", "abbaaaab" },
 };
 
 constexpr auto g_merge_conflict = std::array{
     MergeTestCase{ "adc", "abc", "aec", "" },
     MergeTestCase{ "abqdcf", "abcdef", "abqqef", "" },
+    MergeTestCase{ "baba", "bababba", "baaabba", "" },
 };
 
 constexpr auto g_custom_comp = std::array{
     MergeTestCase{ "abc", "abc", "abC", "abc" },
 };
 
+// counts the comparisons made by the diffs
+struct Counted
+{
+    static inline std::size_t comparisons = 0;
+
+    int value;
+
+    friend bool operator==(const Counted& lhs, const Counted& rhs)
+    {
+        ++comparisons;
+        return lhs.value == rhs.value;
+    }
+};
+
+template <>
+struct std::hash<Counted>
+{
+    std::size_t operator()(const Counted& counted) const noexcept { return std::hash<int>{}(counted.value); }
+};
+
+struct RandomMerge
+{
+    std::string a;
+    std::string base;
+    std::string c;
+};
+
+// bases of up to 20 letters out of 5, each changed a few times into the two other sides
+std::vector<RandomMerge> make_random_merges(std::size_t count)
+{
+    auto rng  = std::mt19937{ 42 };
+    auto pick = [&](int min, int max) { return std::uniform_int_distribution{ min, max }(rng); };
+
+    auto letter = [&] { return static_cast<char>('a' + pick(0, 4)); };
+    auto change = [&](std::string str) {
+        for (auto i = pick(0, 3); i > 0; --i) {
+            auto pos = static_cast<std::size_t>(pick(0, static_cast<int>(str.size())));
+            switch (pick(0, 2)) {
+            case 0: str.insert(pos, 1, letter()); break;
+            case 1: str.erase(pos, 1); break;
+            case 2: str.replace(pos, 1, 1, letter()); break;
+            }
+        }
+        return str;
+    };
+
+    auto merges = std::vector<RandomMerge>(count);
+    for (auto& [a, base, c] : merges) {
+        base.resize(static_cast<std::size_t>(pick(0, 20)));
+        std::ranges::generate(base, letter);
+
+        a = change(base);
+        c = change(base);
+    }
+
+    return merges;
+}
+
 int main()
 {
     using ut::expect, ut::fatal, ut::that;
@@ -90,4 +160,258 @@ int main()
         auto merged = std::move(result).as_merge().value;
         expect(merged == expected) << fmt::format("merged string not the same");
     } | g_custom_comp;
+
+    "merge function should give the same result when the diffs run concurrently"_test = [] {
+        auto check = [](const MergeTestCase& tcase) {
+            const auto& [a, b, c, expected] = tcase;
+
+            auto flags  = dtlx::DiffFlags{ .threads = 2 };
+            auto result = dtlx::merge<std::basic_string>(a, b, c, {}, flags);
+
+            if (expected.empty()) {
+                expect(result.is_conflict()) << fmt::format("merge somehow succeeded: {} | {} | {} ", a, b, c);
+            } else {
+                expect(result.is_merge() >> fatal) << fmt::format("merge fail: {} | {} | {}", a, b, c);
+                expect(std::move(result).as_merge().value == expected) << fmt::format("{} | {} | {}", a, b, c);
+            }
+        };
+
+        std::ranges::for_each(g_merge_success, check);
+        std::ranges::for_each(g_merge_conflict, check);
+    };
+
+    "merge and merge_regions should not depend on the number of threads"_test = [] {
+        // segments as small as possible, so that a diff given more than one thread would be split
+        auto one  = dtlx::DiffFlags{ .threads = 1, .min_segment_size = 1 };
+        auto many = dtlx::DiffFlags{ .threads = 8, .min_segment_size = 1 };
+
+        for (const auto& [a, base, c] : make_random_merges(5'000)) {
+            auto sequential = dtlx::merge<std::basic_string>(a, base, c, {}, one);
+            auto concurrent = dtlx::merge<std::basic_string>(a, base, c, {}, many);
+
+            expect((sequential.is_merge() == concurrent.is_merge()) >> fatal)
+                << fmt::format("{} | {} | {}", a, base, c);
+            if (sequential.is_merge()) {
+                expect(std::move(sequential).as_merge().value == std::move(concurrent).as_merge().value)
+                    << fmt::format("{} | {} | {}", a, base, c);
+            }
+
+            auto regions_sequential = dtlx::merge_regions<std::basic_string>(a, base, c, {}, one);
+            auto regions_concurrent = dtlx::merge_regions<std::basic_string>(a, base, c, {}, many);
+
+            expect(regions_sequential.merged == regions_concurrent.merged) << fmt::format("{} | {} | {}", a, base, c);
+            expect(regions_sequential.conflicts == regions_concurrent.conflicts)
+                << fmt::format("{} | {} | {}", a, base, c);
+        }
+    };
+
+    "can_merge should tell whether merge succeeds"_test = [] {
+        auto check = [](const MergeTestCase& tcase) {
+            const auto& [a, b, c, expected] = tcase;
+
+            for (auto flags : {
+                     dtlx::DiffFlags{},
+                     dtlx::DiffFlags{ .limit = 4 },
+                     dtlx::DiffFlags{ .threads = 2 },
+                     dtlx::DiffFlags{ .anchored = true },
+                 }) {
+                auto merged = dtlx::merge<std::basic_string>(a, b, c, {}, flags);
+                expect(dtlx::can_merge(a, b, c, {}, flags) == merged.is_merge())
+                    << fmt::format("{} | {} | {}", a, b, c);
+            }
+        };
+
+        std::ranges::for_each(g_merge_success, check);
+        std::ranges::for_each(g_merge_conflict, check);
+
+        expect(dtlx::can_merge("ab"sv, "b"sv, "bc"sv));
+        expect(not dtlx::can_merge("adc"sv, "abc"sv, "aec"sv));
+        expect(dtlx::can_merge("eeaede"sv, "beaede"sv, "baebde"sv));
+        expect(not dtlx::can_merge("ccbaccaabacbbcbcc"sv, "ccbacccaabaabbcbcc"sv, "cbacccaabaaabbcbcc"sv));
+    };
+
+    "can_merge should agree with merge on random changes of a base"_test = [] {
+        for (const auto& [a, base, c] : make_random_merges(5'000)) {
+            auto merged = dtlx::merge<std::basic_string>(a, base, c);
+            expect(dtlx::can_merge(a, base, c) == merged.is_merge()) << fmt::format("{} | {} | {}", a, base, c);
+        }
+    };
+
+    "can_merge should stop at an early conflict"_test = [] {
+        // many changes on one side, the diffs are split into steps by the limit, the same for merge
+        auto base = std::vector<Counted>{};
+        for (auto i = 0; i < 100'000; ++i) {
+            base.push_back({ i % 50 == 0 ? 1'000 + i : i % 7 });
+        }
+
+        auto ours = base;
+        for (auto i = std::size_t{ 1'000 }; i < ours.size(); i += 20) {
+            ours[i].value = ours[i].value == 3 ? 4 : 3;
+        }
+
+        auto theirs = base;
+        auto flags  = dtlx::DiffFlags{ .limit = 10'000 };
+        auto check  = [&](bool mergeable) {
+            Counted::comparisons = 0;
+            auto result          = dtlx::can_merge(ours, base, theirs, {}, flags);
+            auto lazy            = std::exchange(Counted::comparisons, 0);
+            auto merged          = dtlx::merge<std::vector>(ours, base, theirs, {}, flags);
+
+            expect(that % result == mergeable);
+            expect(that % merged.is_merge() == mergeable);
+            return std::pair{ lazy, Counted::comparisons };
+        };
+
+        check(true);
+
+        ours[10].value   = 100;
+        theirs[10].value = 200;
+
+        auto [lazy, comparisons] = check(false);
+        expect(that % lazy < comparisons / 4) << fmt::format("can_merge: {}, merge: {}", lazy, comparisons);
+    };
+
+    "merge_regions should merge everything but the conflict regions"_test = [] {
+        for (const auto& [a, b, c, expected] : g_merge_success) {
+            auto result = dtlx::merge_regions<std::basic_string>(a, b, c);
+            expect(result.is_merge() >> fatal) << fmt::format("merge fail: {} | {} | {}", a, b, c);
+            expect(result.merged == expected) << fmt::format("{} | {} | {}", a, b, c);
+        }
+
+        auto result = dtlx::merge_regions<std::basic_string>("xbcdy"sv, "abcde"sv, "zbcdw"sv);
+        expect(result.merged == "bcd"sv);
+        expect((that % result.conflicts.size() == 2u) >> fatal);
+
+        // both sides changed the first and the last element of the base
+        auto first = dtlx::ConflictRegion{ .position = 0, .base = { 0, 1 }, .ours = { 0, 1 }, .theirs = { 0, 1 } };
+        auto last  = dtlx::ConflictRegion{ .position = 3, .base = { 4, 5 }, .ours = { 4, 5 }, .theirs = { 4, 5 } };
+        expect(result.conflicts[0] == first);
+        expect(result.conflicts[1] == last);
+    };
+
+    "write_conflict_markers should write the sides of each conflict between markers"_test = [] {
+        using Lines = std::vector<std::string_view>;
+
+        auto ours   = Lines{ "a", "x", "c", "d" };
+        auto base   = Lines{ "a", "b", "c", "d" };
+        auto theirs = Lines{ "a", "y", "c", "e" };
+
+        auto result = dtlx::merge_regions<std::vector>(ours, base, theirs);
+        expect(that % result.conflicts.size() == 1u);
+
+        auto markers = dtlx::ConflictMarkers<std::string_view>{
+            .ours      = { "<<<<<<< ours" },
+            .base      = {},
+            .separator = { "=======" },
+            .theirs    = { ">>>>>>> theirs" },
+        };
+
+        auto written  = dtlx::write_conflict_markers<std::vector>(result, ours, base, theirs, markers);
+        auto expected = Lines{ "a", "<<<<<<< ours", "x", "=======", "y", ">>>>>>> theirs", "c", "e" };
+        expect(written == expected);
+
+        markers.base = { "||||||| base" };
+
+        written  = dtlx::write_conflict_markers<std::vector>(result, ours, base, theirs, markers);
+        expected = Lines{
+            "a", "<<<<<<< ours", "x", "||||||| base", "b", "=======", "y", ">>>>>>> theirs", "c", "e",
+        };
+        expect(written == expected);
+    };
+
+    "merge_n should merge the changes of every version"_test = [] {
+        for (const auto& [a, b, c, expected] : g_merge_success) {
+            auto result = dtlx::merge_n<std::basic_string>(b, std::array{ a, c });
+            expect(result.is_merge() >> fatal) << fmt::format("merge fail: {} | {} | {}", a, b, c);
+            expect(result.merged == expected) << fmt::format("{} | {} | {}", a, b, c);
+        }
+
+        auto versions = std::array{ "xbcde"sv, "abyde"sv, "abcdz"sv, "abcde"sv };
+        auto result   = dtlx::merge_n<std::basic_string>("abcde"sv, versions, {}, { .threads = 2 });
+        expect(result.is_merge() >> fatal);
+        expect(result.merged == "xbydz"sv);
+
+        auto prepared = dtlx::PreparedSequence{ "abcde"sv };
+        expect(dtlx::merge_n<std::basic_string>(prepared, versions).merged == "xbydz"sv);
+
+        // without any version the base is kept as it is
+        auto none      = std::array<std::string_view, 0>{};
+        auto unchanged = dtlx::merge_n<std::basic_string>("abcde"sv, none);
+        expect(unchanged.is_merge() >> fatal);
+        expect(unchanged.merged == "abcde"sv);
+        expect(dtlx::merge_n<std::basic_string>(prepared, none).merged == "abcde"sv);
+    };
+
+    "merge_n should record the conflict regions with every version"_test = [] {
+        auto versions = std::array{ "axcde"sv, "aycde"sv, "abcdz"sv };
+        auto result   = dtlx::merge_n<std::basic_string>("abcde"sv, versions);
+        expect(result.merged == "acdz"sv);
+        expect((that % result.conflicts.size() == 1u) >> fatal);
+
+        // both versions in conflict replace 'b', the last one keeps it: every side spans the same 'b' of the base
+        const auto& region = result.conflicts.front();
+        expect(that % region.position == 1);
+        expect(region.base == dtlx::IndexRange{ 1, 2 });
+        expect(region.sides == std::vector<dtlx::IndexRange>{ { 1, 2 }, { 1, 2 }, { 1, 2 } });
+
+        // the same regions as the merge of the two versions in conflict alone
+        auto pair = dtlx::merge_regions<std::basic_string>("axcde"sv, "abcde"sv, "aycde"sv);
+        expect((that % pair.conflicts.size() == 1u) >> fatal);
+        expect(pair.conflicts.front().base == region.base);
+        expect(pair.conflicts.front().ours == region.sides[0]);
+        expect(pair.conflicts.front().theirs == region.sides[1]);
+
+        auto prepared = dtlx::PreparedSequence{ "abcde"sv };
+        auto same     = dtlx::merge_n<std::basic_string>(prepared, versions);
+        expect(same.merged == result.merged);
+        expect(same.conflicts == result.conflicts);
+    };
+
+    "merge_n should not depend on the number of threads"_test = [] {
+        // segments as small as possible, so that a diff given more than one thread would be split
+        auto one  = dtlx::DiffFlags{ .threads = 1, .min_segment_size = 1 };
+        auto many = dtlx::DiffFlags{ .threads = 8, .min_segment_size = 1 };
+
+        for (const auto& [a, base, c] : make_random_merges(5'000)) {
+            auto versions   = std::array{ std::string_view{ a }, std::string_view{ c } };
+            auto sequential = dtlx::merge_n<std::basic_string>(base, versions, {}, one);
+            auto concurrent = dtlx::merge_n<std::basic_string>(base, versions, {}, many);
+
+            expect(sequential.merged == concurrent.merged) << fmt::format("{} | {} | {}", a, base, c);
+            expect(sequential.conflicts == concurrent.conflicts) << fmt::format("{} | {} | {}", a, base, c);
+
+            auto prepared = dtlx::PreparedSequence{ std::string_view{ base } };
+            auto same     = dtlx::merge_n<std::basic_string>(prepared, versions, many);
+            expect(same.merged == sequential.merged) << fmt::format("{} | {} | {}", a, base, c);
+            expect(same.conflicts == sequential.conflicts) << fmt::format("{} | {} | {}", a, base, c);
+        }
+    };
+
+    "merge_n of a prepared base should compare with its KeyEqual"_test = [] {
+        struct CharHash
+        {
+            std::size_t operator()(char c) const { return std::hash<int>{}(std::tolower(c)); }
+        };
+
+        struct CharEqual
+        {
+            bool ignore_case = false;
+
+            bool operator()(char a, char b) const
+            {
+                return ignore_case ? std::tolower(a) == std::tolower(b) : a == b;
+            }
+        };
+
+        // the same addition up to case
+        auto versions = std::array{ "abXc"sv, "abxc"sv };
+
+        auto exact = dtlx::PreparedSequence{ "abc"sv, CharHash{}, CharEqual{} };
+        expect(dtlx::merge_n<std::basic_string>(exact, versions).is_conflict());
+
+        auto ignoring = dtlx::PreparedSequence{ "abc"sv, CharHash{}, CharEqual{ .ignore_case = true } };
+        auto result   = dtlx::merge_n<std::basic_string>(ignoring, versions);
+        expect(result.is_merge() >> fatal);
+        expect(result.merged == "abXc"sv);
+    };
 }
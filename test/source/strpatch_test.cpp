@@ -6,9 +6,12 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace ut = boost::ut;
 
@@ -18,6 +21,46 @@ struct PatchTestCase
     std::string_view b;
 };
 
+// records whether it has been moved from, a moved-from std::string is not guaranteed to be empty
+struct Tracked
+{
+    char value;
+    bool moved_from = false;
+
+    Tracked(char value)
+        : value{ value }
+    {
+    }
+
+    Tracked(const Tracked& other)
+        : value{ other.value }
+    {
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : value{ other.value }
+    {
+        other.moved_from = true;
+    }
+
+    Tracked& operator=(const Tracked& other)
+    {
+        value      = other.value;
+        moved_from = false;
+        return *this;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept
+    {
+        value            = other.value;
+        moved_from       = false;
+        other.moved_from = true;
+        return *this;
+    }
+
+    bool operator==(const Tracked& other) const { return value == other.value; }
+};
+
 constexpr auto g_test_cases = std::array{
     PatchTestCase{ "abc", "abd" },
     PatchTestCase{ "acbdeacbed", "acebdabbabed" },
@@ -87,4 +130,62 @@ int main()
         auto patched = dtlx::patch<std::basic_string>(a, ses);
         expect(that % b == patched) << fmt::format("\nSES: {}", ses.get());
     } | g_test_cases;
+
+    "patch should be correct on SES produced with common suffix trimmed"_test = [](const auto& tcase) {
+        const auto& [a, b]         = tcase;
+        auto [lcs, ses, edit_dist] = dtlx::diff(a, b, {}, { .trim_suffix = true });
+
+        auto patched = dtlx::patch<std::basic_string>(a, ses);
+        expect(that % b == patched) << fmt::format("\nSES: {}", ses.get());
+    } | g_test_cases;
+
+    "patch should write to an output iterator"_test = [](const auto& tcase) {
+        const auto& [a, b] = tcase;
+        auto [lcs, ses, _] = dtlx::diff(a, b);
+        auto runs          = dtlx::diff_runs(a, b).ses;
+
+        auto patched = std::string(b.size(), '\0');
+        expect(dtlx::patch(a, ses, patched.begin()) == patched.end());
+        expect(that % b == patched) << fmt::format("\nSES: {}", ses.get());
+
+        auto appended = std::string{};
+        dtlx::patch(a, runs, std::back_inserter(appended));
+        expect(that % b == appended);
+    } | g_test_cases;
+
+    "patch should move the kept elements out of an rvalue range"_test = [] {
+        auto a = std::vector<Tracked>{ 'a', 'b', 'c' };
+        auto b = std::vector<Tracked>{ 'a', 'q', 'c' };
+
+        auto ses     = dtlx::diff(a, b).ses;
+        auto patched = dtlx::patch<std::vector>(std::move(a), ses);
+        expect(patched == b);
+        expect(a[0].moved_from and a[2].moved_from) << "common elements are not moved";
+        expect(not a[1].moved_from) << "deleted element should be left as is";
+        expect(std::ranges::none_of(patched, &Tracked::moved_from));
+
+        // an lvalue range is copied from
+        auto c = std::vector<Tracked>{ 'a', 'b', 'c' };
+        expect(dtlx::patch<std::vector>(c, ses) == b);
+        expect(std::ranges::none_of(c, &Tracked::moved_from)) << "elements of an lvalue range are moved";
+    };
+
+    "patch should give the same result on many threads"_test = [] {
+        // long enough for the SES to be split into chunks
+        auto a = std::string{};
+        auto b = std::string{};
+        for (auto i = 0; i < 100'000; ++i) {
+            a += "abc";
+            b += i % 7 == 0 ? "axc" : i % 11 == 0 ? "abcd" : "abc";
+        }
+
+        auto ses = dtlx::diff(a, b).ses;
+        for (auto threads : { 1u, 2u, 3u, 8u }) {
+            expect(dtlx::patch<std::basic_string>(a, ses, threads) == b) << fmt::format("threads: {}", threads);
+
+            auto patched = std::string(b.size(), '\0');
+            expect(dtlx::patch(a, ses, patched.begin(), threads) == patched.end());
+            expect(patched == b) << fmt::format("threads: {}", threads);
+        }
+    };
 }